@@ -6,7 +6,8 @@
 #include <fstream>
 #include <string>
 #include <queue>
-#include <unordered_set>
+#include <iterator>
+#include <algorithm>
 
 using namespace std;
 
@@ -16,7 +17,7 @@ using namespace std;
 struct node {
     int vertex;
     double cost;
-    
+
     node(int vt, double c): vertex(vt), cost(c) {}
 
     bool operator< (const node& other) const {
@@ -26,9 +27,9 @@ struct node {
 
 typedef priority_queue<node> mypq_type;
 
-Vertex::Vertex(int id): id(id), val(0) {}
+Vertex::Vertex(int32_t id): id(id), val(0), edge_mst(-1) {}
 
-Edge::Edge(Vertex *v1, Vertex *v2): first(v1), second(v2), val(0) {}
+Edge::Edge(int32_t v1, int32_t v2): first(v1), second(v2), val(0) {}
 
 ostream& operator<<(ostream& out, const Vertex& v) {
     out << "v" << v.id << ": " << v.val;
@@ -36,54 +37,125 @@ ostream& operator<<(ostream& out, const Vertex& v) {
 }
 
 ostream& operator<<(ostream& out, const Edge& e) {
-    out << "e: " << e.first->id << "--" << e.second->id << ", " << e.val;
+    out << "e: " << e.first << "--" << e.second << ", " << e.val;
     return out;
 }
 
-Graph::Graph(size_t size, double density): v(size), e(0) {
-    for(int i = 0; i < size; i++) {
-        Vertex vt(i);
-        graph.push_back(vt);
-    }
+Graph::Graph(size_t size, double density): v(size), e(0),
+        vertex_val(size, 0), vertex_mst(size, -1),
+        adj_begin(size, 0), adj_size(size, 0), adj_cap(size, 0) {
     default_random_engine el(r());
     uniform_real_distribution<double> ud(0, 1);
     uniform_real_distribution<double> uv(1.0, 10.0);
-    for(int i = 0; i < size; i++) {
-        for(int j = i + 1; j < size; j++) {
+    for(int i = 0; i < v; i++) {
+        for(int j = i + 1; j < v; j++) {
             if(ud(el) < density) {
-                Edge ed(&graph[i], &graph[j]);
-                ed.val = uv(el);
-                graph[i].edges.push_back(ed);
-                graph[j].edges.push_back(ed);
-                e++;
+                insert_edge(i, j, uv(el));
             }
         }
     }
 }
 
-Graph::Graph(string filename) {
+Graph::Graph(string filename): e(0) {
     ifstream data(filename);
     istream_iterator<int> start(data), end;
-    v = *start;
-    e = 0;
-    ++start;
-    for(int i = 0; i < v; i++) {
-        Vertex vt(i);
-        graph.push_back(vt);
+    v = (start != end) ? *start : 0;
+    vertex_val.assign(v, 0);
+    vertex_mst.assign(v, -1);
+    adj_begin.assign(v, 0);
+    adj_size.assign(v, 0);
+    adj_cap.assign(v, 0);
+    if(start != end) {
+        ++start;
     }
     while(start != end) {
         int i = *start;
-        ++start;
+        if(++start == end) break;
         int j = *start;
+        if(++start == end) break;
+        double val = static_cast<double>(*start);
         ++start;
-        Edge ed(&graph[i], &graph[j]);
-        ed.val = static_cast<double>(*start);
-        graph[i].edges.push_back(ed);
-        ++start;
-        ++e;
+        if(i < 0 || i >= v || j < 0 || j >= v || i == j) {
+            continue;
+        }
+        // the file lists every edge in both directions, store it only once
+        int32_t id = find_edge(i, j);
+        if(id < 0) {
+            insert_edge(i, j, val);
+        } else {
+            edge_val[id] = val;
+        }
+    }
+}
+
+int32_t Graph::insert_edge(int32_t x, int32_t y, double a) {
+    int32_t id;
+    if(free_edges.empty()) {
+        id = edge_val.size();
+        edge_first.push_back(x);
+        edge_second.push_back(y);
+        edge_val.push_back(a);
+    } else {
+        id = free_edges.back();
+        free_edges.pop_back();
+        edge_first[id] = x;
+        edge_second[id] = y;
+        edge_val[id] = a;
+    }
+    append_slot(x, y, id);
+    append_slot(y, x, id);
+    e++;
+    return id;
+}
+
+void Graph::append_slot(int32_t x, int32_t y, int32_t id) {
+    if(adj_size[x] == adj_cap[x]) {
+        int32_t end = adj_target.size();
+        int32_t cap = max(4, 2 * adj_cap[x]);
+        if(adj_cap[x] > 0 && adj_begin[x] + adj_cap[x] == end) {
+            // the range is the last one, simply grow it in place
+            adj_target.resize(adj_begin[x] + cap);
+            adj_edge.resize(adj_begin[x] + cap);
+        } else {
+            adj_target.resize(end + cap);
+            adj_edge.resize(end + cap);
+            copy(adj_target.begin() + adj_begin[x], adj_target.begin() + adj_begin[x] + adj_size[x], adj_target.begin() + end);
+            copy(adj_edge.begin() + adj_begin[x], adj_edge.begin() + adj_begin[x] + adj_size[x], adj_edge.begin() + end);
+            adj_begin[x] = end;
+        }
+        adj_cap[x] = cap;
     }
-    e = e / 2;
-}    
+    int32_t slot = adj_begin[x] + adj_size[x]++;
+    adj_target[slot] = y;
+    adj_edge[slot] = id;
+}
+
+void Graph::remove_slot(int32_t x, int32_t id) {
+    int32_t first = adj_begin[x];
+    int32_t last = first + adj_size[x] - 1;
+    for(int32_t slot = first; slot <= last; ++slot) {
+        if(adj_edge[slot] == id) {
+            // the order of the neighbors does not matter, fill the gap with the last one
+            adj_target[slot] = adj_target[last];
+            adj_edge[slot] = adj_edge[last];
+            adj_size[x]--;
+            return;
+        }
+    }
+}
+
+int32_t Graph::find_edge(int32_t x, int32_t y) {
+    if(adj_size[y] < adj_size[x]) {
+        swap(x, y);
+    }
+    const int32_t* target = adj_target.data() + adj_begin[x];
+    for(int32_t k = 0; k < adj_size[x]; ++k) {
+        if(target[k] == y) {
+            return adj_edge[adj_begin[x] + k];
+        }
+    }
+    return -1;
+}
 
 int Graph::V() {
     return v;
@@ -97,31 +169,26 @@ bool Graph::adjacent(int x, int y) {
     if(x < 0 || x >= v || y < 0 || y >= v || x == y) {
         return false;
     }
-    vector<Edge> x_edges = graph[x].edges;
-    for(vector<Edge>::iterator it = x_edges.begin(); it != x_edges.end(); ++it) {
-        if(it->first->id == y || it->second->id == y) {
-            return true;
-        }
-    }
-    return false;
+    return find_edge(x, y) >= 0;
 }
 
 vector<int> Graph::neighbors(int x) {
     vector<int> nei;
-    if(x < 0 || x >= v) {
-        return nei;
-    }
-    vector<Edge> x_edges = graph[x].edges;
-    for(vector<Edge>::iterator it = x_edges.begin(); it != x_edges.end(); ++it) {
-        if(it->first->id == x) {
-            nei.push_back(it->second->id);
-        } else {
-            nei.push_back(it->first->id);
-        }
+    NeighborRange range = neighbor_range(x);
+    nei.reserve(range.size());
+    for(Neighbor nb : range) {
+        nei.push_back(nb.id);
     }
     return nei;
 }
 
+NeighborRange Graph::neighbor_range(int x) const {
+    if(x < 0 || x >= v) {
+        return NeighborRange(nullptr, nullptr, nullptr, 0);
+    }
+    return NeighborRange(adj_target.data() + adj_begin[x], adj_edge.data() + adj_begin[x], edge_val.data(), adj_size[x]);
+}
+
 bool Graph::add_edge(int x, int y) {
     if(x < 0 || x >= v || y < 0 || y >= v || x == y
             || adjacent(x, y)) {
@@ -129,96 +196,96 @@ bool Graph::add_edge(int x, int y) {
     }
     default_random_engine el(r());
     uniform_real_distribution<double> uv(1.0, 10.0);
-    Edge ed(&graph[x], &graph[y]);
-    ed.val = uv(el);
-    graph[x].edges.push_back(ed);
-    graph[y].edges.push_back(ed);
-    e++;
+    insert_edge(x, y, uv(el));
     return true;
 }
-        
+
 bool Graph::delete_edge(int x, int y) {
-    if(x < 0 || x >= v || y < 0 || y >= v || x == y 
-            || !adjacent(x, y)) {
+    if(x < 0 || x >= v || y < 0 || y >= v || x == y) {
         return false;
     }
-    vector<Edge>* x_edges = &(graph[x].edges);
-    for(vector<Edge>::iterator it = x_edges->begin(); it != x_edges->end(); ++it) {
-        if(it->first->id == y || it->second->id == y) {
-            x_edges->erase(it);
-            break;
-        }
+    int32_t id = find_edge(x, y);
+    if(id < 0) {
+        return false;
     }
-    vector<Edge>* y_edges = &(graph[y].edges);
-    for(vector<Edge>::iterator it = y_edges->begin(); it != y_edges->end(); ++it) {
-        if(it->first->id == x || it->second->id == x) {
-            y_edges->erase(it);
-            break;
-        }
+    remove_slot(x, id);
+    remove_slot(y, id);
+    // an MST edge can only be referenced by its own endpoints
+    if(vertex_mst[x] == id) {
+        vertex_mst[x] = -1;
     }
+    if(vertex_mst[y] == id) {
+        vertex_mst[y] = -1;
+    }
+    free_edges.push_back(id);
     e--;
     return true;
 }
 
-Vertex* Graph::get_vertex(int x) {
+Vertex Graph::get_vertex(int x) {
     if(x < 0 || x >= v) {
-        return nullptr;
+        return Vertex(-1);
+    }
+    Vertex vt(x);
+    vt.val = vertex_val[x];
+    vt.edge_mst = vertex_mst[x];
+    return vt;
+}
+
+Edge Graph::get_mst_edge(int x) {
+    Edge ed(-1, -1);
+    if(x < 0 || x >= v || vertex_mst[x] < 0) {
+        return ed;
     }
-    return &(graph[x]);
+    int32_t id = vertex_mst[x];
+    ed.first = (edge_first[id] == x) ? edge_second[id] : edge_first[id];
+    ed.second = x;
+    ed.val = edge_val[id];
+    return ed;
 }
 
 double Graph::get_node_value(int x) {
     if(x < 0 || x >= v) {
         return -1;
     }
-    return graph[x].val;
+    return vertex_val[x];
 }
 
 bool Graph::set_node_value(int x, double a) {
     if(x < 0 || x >= v) {
         return false;
     }
-    graph[x].val = a;
+    vertex_val[x] = a;
     return true;
 }
 
 double Graph::get_edge_value(int x, int y) {
-    if(x < 0 || x >= v || y < 0 || y >= v || x == y
-            || !adjacent(x, y)) {
+    if(x < 0 || x >= v || y < 0 || y >= v || x == y) {
         return -1;
     }
-    vector<Edge>* x_edges = &(graph[x].edges);
-    for(vector<Edge>::iterator it = x_edges->begin(); it != x_edges->end(); ++it) {
-        if(it->first->id == y || it->second->id == y) {
-            return it->val;
-        }
-    }
-    return -1;
+    int32_t id = find_edge(x, y);
+    return (id < 0) ? -1 : edge_val[id];
 }
 
 bool Graph::set_edge_value(int x, int y, double a) {
-    if(x < 0 || x >= v || y < 0 || y >= v || x == y
-            || !adjacent(x, y)) {
+    if(x < 0 || x >= v || y < 0 || y >= v || x == y) {
         return false;
     }
-    vector<Edge>* y_edges = &(graph[y].edges);
-    for(vector<Edge>::iterator it = y_edges->begin(); it != y_edges->end(); ++it) {
-        if(it->first->id == x || it->second->id == x) {
-            it->val = a;
-        }
-    }
-    vector<Edge>* x_edges = &(graph[x].edges);
-    for(vector<Edge>::iterator it = x_edges->begin(); it != x_edges->end(); ++it) {
-        if(it->first->id == y || it->second->id == y) {
-            it->val = a;
-            return true;
-        }
+    int32_t id = find_edge(x, y);
+    if(id < 0) {
+        return false;
     }
-    return false;
+    edge_val[id] = a;
+    return true;
 }
 
 vector<Vertex> Graph::get_vertices() {
-    return graph;
+    vector<Vertex> vertices;
+    vertices.reserve(v);
+    for(int i = 0; i < v; ++i) {
+        vertices.push_back(get_vertex(i));
+    }
+    return vertices;
 }
 
 // This funciton implement Prim algorithm to find the MST
@@ -227,16 +294,17 @@ double Graph::find_mst_prim() {
     // Total cost of the MST
     double cost = 0;
 
-    // Open set stores the unvisited node
-    unordered_set<int> open;
-    // Close set stors the visited node in the MST
-    unordered_set<int> close;
-    for(int i = 0; i < v; ++i) {
-        open.insert(i);
+    // Visiting state of every node: open (unvisited), in the queue or closed (visited, in the MST)
+    enum { OPEN, QUEUED, CLOSED };
+    vector<char> state(v, OPEN);
+    vertex_mst.assign(v, -1);
+    if(v == 0) {
+        return cost;
     }
     // The search starts from node 0. Node 0 works as a root and no MST edgeis bounded to node 0.
     node start(0, 0);
-    // The priority queue stores the visiting node connecting to the MST 
+    state[0] = QUEUED;
+    // The priority queue stores the visiting node connecting to the MST
     mypq_type pq;
     pq.push(start);
     // Running the Prim algorithm
@@ -245,32 +313,28 @@ double Graph::find_mst_prim() {
         node curr = pq.top();
         pq.pop();
         // Skip the processed nodes
-        if(close.find(curr.vertex) != close.end()) {
+        if(state[curr.vertex] == CLOSED) {
             continue;
         }
-        close.insert(curr.vertex);
+        state[curr.vertex] = CLOSED;
         cost += curr.cost;
-        // Loop the neightbors of the curr Vertex
-        for(Edge &edge : graph[curr.vertex].edges) {
-            int vt = 0;
-            if(edge.first->id == curr.vertex) {
-                vt = edge.second->id;
-            } else {
-                vt = edge.first->id;
-            }
+        // Loop the neightbors of the curr Vertex, the range is contiguous
+        const int32_t* edge = adj_edge.data() + adj_begin[curr.vertex];
+        for(Neighbor nb : neighbor_range(curr.vertex)) {
             // case 1: the neighbor is unvisited
-            if(open.find(vt) != open.end()) {
-                graph[vt].edge_mst = &edge;
-                open.erase(vt);
-                node next(vt, edge.val);
+            if(state[nb.id] == OPEN) {
+                vertex_mst[nb.id] = *edge;
+                state[nb.id] = QUEUED;
+                node next(nb.id, nb.val);
                 pq.push(next);
-            } 
-            // case 2: the neighbor is in the queue and a shorter bounding edge is found 
-            else if(close.find(vt) == close.end() && edge.val < graph[vt].edge_mst->val) {
-                graph[vt].edge_mst = &edge;
-                node next(vt, edge.val);
+            }
+            // case 2: the neighbor is in the queue and a shorter bounding edge is found
+            else if(state[nb.id] == QUEUED && nb.val < edge_val[vertex_mst[nb.id]]) {
+                vertex_mst[nb.id] = *edge;
+                node next(nb.id, nb.val);
                 pq.push(next);
             }
+            ++edge;
         }
     }
     return cost;
@@ -279,12 +343,13 @@ double Graph::find_mst_prim() {
 ostream& operator<<(ostream& out, Graph &g) {
     out << "Number of vertices: " << g.V() << endl;
     out << "Number of edges: " << g.E() << endl;
-    vector<Vertex> vertices = g.get_vertices();
-    int n = vertices.size();
+    int n = g.V();
     for(int i = 0; i < n; i++) {
-        cout << vertices[i] << " : ";
-        for(vector<Edge>::iterator it = vertices[i].edges.begin(); it != vertices[i].edges.end(); ++it) {
-            cout << *it << "; ";
+        cout << g.get_vertex(i) << " : ";
+        for(Neighbor nb : g.neighbor_range(i)) {
+            Edge ed(i, nb.id);
+            ed.val = nb.val;
+            cout << ed << "; ";
         }
         cout << endl;
     }
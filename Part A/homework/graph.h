@@ -17,15 +17,13 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <cstdint>
 
-// Vertex is the node in the graph
-struct Vertex;
-
-// Edge is the edge connecting two nodes in the graph
+// Edge is the edge connecting two nodes in the graph, returned by value
 struct Edge {
     
-    // the first and second vertices the edge connects
-    Vertex *first, *second;
+    // the ids of the first and second vertices the edge connects
+    int32_t first, second;
 
     // the value in the edge, e.g. length (non-negative value)
     double val;
@@ -33,32 +31,104 @@ struct Edge {
 /**
     @brief  edge constructor
 
-    @param  v1 is the first vertex the edge connects
-    @param  v2 is the second vertex the edge connects 
+    @param  v1 is the id of the first vertex the edge connects
+    @param  v2 is the id of the second vertex the edge connects 
 */
-    Edge(Vertex* v1, Vertex* v2);
+    Edge(int32_t v1, int32_t v2);
 };
 
+// Vertex is the node in the graph, returned by value
 struct Vertex {
 
     // the id of the vertex
-    int id;
+    int32_t id;
 
     // the value in the vertex
     double val;
 
-    // the edge list connecting to the vertex
-    vector<Edge> edges;
-
-    // The ptr to the edge in the minimum spanning tree connecting this Vertex. The first node (node 0) is the root with null_ptr
-    Edge *edge_mst;
+    // The id of the edge in the minimum spanning tree connecting this Vertex. The first node (node 0) is the root with -1
+    int32_t edge_mst;
 
 /**
     @brief  vertex constructor
 
     @param  id is the id of the vertex
 */
-    Vertex(int id);
+    Vertex(int32_t id);
+};
+
+// Neighbor is a node next to a vertex together with the edge leading to it
+struct Neighbor {
+
+    // the id of the neighbor
+    int32_t id;
+
+    // the value of the edge to the neighbor
+    double val;
+};
+
+// NeighborRange is a view on the neighbors of a vertex, it allocates nothing and is valid until the graph is changed
+class NeighborRange {
+
+public:
+
+    class iterator {
+
+    public:
+
+        iterator(const int32_t* t, const int32_t* e, const double* v): target(t), edge(e), edge_val(v) {}
+
+        Neighbor operator*() const {
+            Neighbor nb = {*target, edge_val[*edge]};
+            return nb;
+        }
+
+        iterator& operator++() {
+            ++target;
+            ++edge;
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return target != other.target;
+        }
+
+    private:
+
+        // the current slot in the contiguous range of the vertex
+        const int32_t *target, *edge;
+
+        // the values of all edges, indexed by edge id
+        const double* edge_val;
+    };
+
+/**
+    @brief  neighbor range constructor
+
+    @param  t is the first neighbor id of the range
+    @param  e is the first edge id of the range
+    @param  v is the edge value array
+    @param  n is the number of neighbors
+*/
+    NeighborRange(const int32_t* t, const int32_t* e, const double* v, int32_t n): target(t), edge(e), edge_val(v), n(n) {}
+
+    iterator begin() const {
+        return iterator(target, edge, edge_val);
+    }
+
+    iterator end() const {
+        return iterator(target + n, edge + n, edge_val);
+    }
+
+    int32_t size() const {
+        return n;
+    }
+
+private:
+
+    const int32_t *target, *edge;
+    const double* edge_val;
+    int32_t n;
 };
 
 // output stream operator << override for vertex 
@@ -72,14 +142,59 @@ class Graph {
 private:
 
     // v is the total number of vertices, e is the total number of edges
-    int v, e;
+    int32_t v, e;
+
+    // The graph is stored as struct of arrays with 32 bit indices instead of pointers, so growing any of the arrays never invalidates anything.
+
+    // per vertex: the value and the id of the edge connecting it to the MST (-1 if none)
+    vector<double> vertex_val;
+    vector<int32_t> vertex_mst;
 
-    // the list of all the vertices in the graph
-    vector<Vertex> graph;
+    // per edge id: the endpoints and the value, ids of deleted edges are reused
+    vector<int32_t> edge_first, edge_second;
+    vector<double> edge_val;
+    vector<int32_t> free_edges;
+
+    // per vertex: range [adj_begin, adj_begin + adj_size) in adj_target / adj_edge with room for adj_cap entries
+    vector<int32_t> adj_begin, adj_size, adj_cap;
+
+    // per slot of a range: the neighbor and the id of the edge leading to it
+    vector<int32_t> adj_target, adj_edge;
 
     // random generator
     random_device r;
 
+/**
+    @brief  add a new edge between x and y, the vertices are not checked
+
+    @return the id of the new edge
+*/
+    int32_t insert_edge(int32_t x, int32_t y, double a);
+
+/**
+    @brief  append the edge to the range of x, the range is moved to the end of the arrays with doubled room if it is full
+
+    @param  x is the id of node x
+    @param  y is the id of the neighbor
+    @param  id is the id of the edge
+*/
+    void append_slot(int32_t x, int32_t y, int32_t id);
+
+/**
+    @brief  remove the edge from the range of x
+
+    @param  x is the id of node x
+    @param  id is the id of the edge
+*/
+    void remove_slot(int32_t x, int32_t id);
+
+/**
+    @brief  find the edge between x and y in the range of the vertex with fewer edges
+
+    @return the id of the edge or -1 if there is none
+*/
+    int32_t find_edge(int32_t x, int32_t y);
+
 public:
 
 /**
@@ -129,6 +244,14 @@ public:
 */
     vector<int> neighbors(int x);
 
+/**
+    @brief  get all the neighbors of a vertex without allocating
+
+    @param  x is the id of node x
+    @return a range of (neighbor id, edge value) of node x, empty if there is no node x
+*/
+    NeighborRange neighbor_range(int x) const;
+
 /**
     @brief  add an edge from x to y, if it is not there
 
@@ -148,12 +271,21 @@ public:
     bool delete_edge(int x, int y);
 
 /**
-    @brief  get the pointer to the node x
+    @brief  get the node x
 
     @param  x is the id of node x
-    @return the pointer to the node x
+    @return a copy of the node x, the id is -1 if there is no node x
 */
-    Vertex* get_vertex(int x);
+    Vertex get_vertex(int x);
+
+/**
+    @brief  get the edge connecting node x to the minimum spanning tree, call find_mst_prim() first
+
+    @param  x is the id of node x
+    @return the edge from the parent of x to x, the ids are -1 if there is none
+*/
+    Edge get_mst_edge(int x);
+
 /**
     @brief  get the value of node x
 
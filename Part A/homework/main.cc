@@ -13,7 +13,7 @@ int main(void) {
     cout << "-------------------------------" << endl;
     cout << "The edge list of the MST is:\n" << endl;
     for(int i = 1; i < n; ++i) {
-        cout << *(g.get_vertex(i)->edge_mst) << endl;
+        cout << g.get_mst_edge(i) << endl;
     }
     cout << "-------------------------------" << endl;
     return 0;
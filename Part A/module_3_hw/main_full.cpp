@@ -7,6 +7,13 @@
 #include <vector>
 #include <chrono>
 #include <limits>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <cassert>
 
 using namespace std::chrono;
 using namespace std;
@@ -17,160 +24,286 @@ enum EdgeWeight { NO_CON = 0, MIN = 1, MAX = 9 };
 void swap(int& x, int& y); // fct declaration
 
 // #############################################################################
-// Priority Queue as vector based min heap
+// std::vector allocator returning cache line (64 byte) aligned memory
+// #############################################################################
+template <typename T, size_t ALIGN = 64>
+struct AlignedAllocator {
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, ALIGN> other;
+  };
+
+  AlignedAllocator() {};
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, ALIGN>&) {};
+
+  T* allocate(size_t count) {
+    void* ptr = nullptr;
+#ifdef _MSC_VER
+    ptr = _aligned_malloc(count * sizeof(T), ALIGN);
+#else
+    if (posix_memalign(&ptr, ALIGN, count * sizeof(T)) != 0) {
+      ptr = nullptr;
+    }
+#endif
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_t) {
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+  }
+};
+
+template <typename T, typename U, size_t ALIGN>
+bool operator==(const AlignedAllocator<T, ALIGN>&, const AlignedAllocator<U, ALIGN>&) {
+  return true;
+}
+
+template <typename T, typename U, size_t ALIGN>
+bool operator!=(const AlignedAllocator<T, ALIGN>&, const AlignedAllocator<U, ALIGN>&) {
+  return false;
+}
+
+// #############################################################################
+// Priority Queue as vector based indexed d-ary heap
 // see https://www.geeksforgeeks.org/binary-heap/
 // https://youtu.be/B7hVxCmfPtM
+// https://en.wikipedia.org/wiki/D-ary_heap
 // using integer arithmetic (implicit flooring division, i.e. 5/2 = 2)
-// heap parent is at index (i/2)
-// left child is at index (2*i)
-// right child is at index (2*i + 1)
+// heap parent is at index (i-1)/ARITY
+// children are at index ARITY*i + 1 ... ARITY*i + ARITY
+// K: priority, V: payload carried along (e.g. the vertex of a distance)
+// Compare(a, b): true if a has to come out before b, less<K> -> min heap
+// every element gets an id when it is added (0, 1, 2, ... in insertion order),
+// the heap stores the ids and pos[id] remembers the heap slot of each id, so a
+// priority can be changed in O(log n) without searching the heap
 // #############################################################################
-
+template <typename K, typename V = int, class Compare = less<K>, int ARITY = 2>
 class PriorityQueue {
+  static_assert(ARITY >= 2, "a heap needs at least two children per node");
+
 public:
   // create simple empty priority queue
-  PriorityQueue() {
-    heap.push_back(0); // dummy element for indexing to work out
-  };
-  PriorityQueue(std::vector<int> v) {
-    heap.push_back(0); // dummy element for indexing to work out
-    for (int i = 0; i < v.size(); i++) {
-      heap.push_back(v[i]);
+  PriorityQueue() : heap(PAD) {};
+  // the element v[i] gets the id i
+  PriorityQueue(const std::vector<K>& v) : heap(PAD) {
+    for (int i = 0; i < static_cast<int>(v.size()); i++) {
+      heap.push_back(Slot{v[i], i});
+      pos.push_back(i);
+      value.push_back(V());
     }
     // sort entire heap to get min heap
-    Min_Heapify_Queue();
+    Heapify();
   };
 
   ~PriorityQueue() {};
 
   void Print();
 
-  void Push(int value); // add new element to heap
+  // add new element to heap, returns its id
+  int Push(const K& priority, const V& payload = V());
 
-  int Size() {
-    return heap.size() - 1;
+  int Size() const {
+    return heap.size() - PAD;
   }; // return number of elements in the heap
 
+  bool Empty() const {
+    return Size() == 0;
+  }
+
   // return the minimum value in the heap
-  int Top() {
-    return heap[1];
+  const K& Top() const {
+    return heap[PAD].key;
   }
 
-  void Change_Prioirity(int idx, int new_priority) {
-    idx       = idx + 1; // indexing starts at 1
-    heap[idx] = new_priority;
-    // now that we have changed a priority, we need to re-heapify the heap
-    // but here we have to work our way down the heap to the bottom of the tree
-    for (int i = Parent(idx); i <= Size() / 2; i++) {
-      Min_Heapify(i);
-    }
-    // now we work our way up the tree to the top of the tree
-    for (int i = Parent(idx); i > 0; i--) {
-      Min_Heapify(i);
-    }
+  // return the id of the minimum value in the heap
+  int Top_Id() const {
+    return heap[PAD].id;
   }
 
-  // return the min value from the top if the heap and remove it
-  // then reorder the heap to maintain the min heap property
-  int Pop() {
-    int minVal = heap[1];
-    heap[1]    = heap.back(); // swap old value with the end of the vector
-    heap.pop_back();          // remove the end of the vector
-    Min_Heapify(1);           // reorder the heap, starting with idx 0
-    return minVal;
+  // return the payload of the minimum value in the heap
+  const V& Top_Value() const {
+    return value[Top_Id()];
   }
 
-  // turn the vector into a min heap at index i
-  void Min_Heapify(int i);
+  // true if the element with this id is still in the heap
+  bool Contains(int id) const {
+    return (id >= 0) && (id < static_cast<int>(pos.size())) && (pos[id] >= 0);
+  }
 
-  void Min_Heapify_Queue() {
-    // walk trough the heap and reorder it from the bottom up
-    // but last nodes are already in the correct order -> Size()/2
-    for (int i = Size() / 2; i > 0; i--) {
-      Min_Heapify(i);
+  // priority of an element in the heap, the id must not be popped yet
+  const K& Get_Priority(int id) const {
+    assert(Contains(id));
+    return At(pos[id]).key;
+  }
+
+  // payload of an element, also valid after it was popped
+  const V& Get_Value(int id) const {
+    return value[id];
+  }
+
+  // give the element with this id a new priority, the element only moves up
+  // or down its own path of the tree -> O(log n)
+  // returns false if the id is not in the heap
+  bool Change_Priority(int id, const K& newPriority);
+
+  // return the min value from the top if the heap and remove it
+  // then reorder the heap to maintain the min heap property
+  K Pop() {
+    Slot top     = At(0);
+    pos[top.id]  = -1;
+    int last     = Size() - 1;
+    if (last > 0) {
+      At(0)         = At(last); // move the end of the vector to the top
+      pos[At(0).id] = 0;
+    }
+    heap.pop_back(); // remove the end of the vector
+    if (last > 0) {
+      Sift_Down(0); // reorder the heap, starting with idx 0
     }
+    return top.key;
   }
 
 private:
-  vector<int> heap;
+  struct Slot {
+    K key;
+    int32_t id;
+  };
 
-  int Parent(int i) {
-    return (i) / 2;
-  }
+  // the heap starts after PAD unused slots, so the children of node i sit at
+  // heap[ARITY * (i + 1)] ... and every group of siblings starts on a multiple
+  // of ARITY; with an aligned vector and ARITY * sizeof(Slot) <= 64 (e.g. int
+  // keys and ARITY 8) the siblings share a cache line
+  static const int PAD = ARITY - 1;
 
-  // to get index of left child of node at index i
-  int Left(int i) {
-    return (2 * i);
+  Slot& At(int i) {
+    return heap[i + PAD];
   }
 
-  // to get index of right child of node at index i
-  int Right(int i) {
-    return (2 * i + 1);
+  const Slot& At(int i) const {
+    return heap[i + PAD];
   }
-};
 
-// A recursive method to heapify a subtree with the root at given index
-// This method assumes that the subtrees are already heapified
-void PriorityQueue::Min_Heapify(int i) {
-  int l        = Left(i);
-  int r        = Right(i);
-  int smallest = i;
+  // move the element at index i up / down until the heap property holds
+  void Sift_Up(int i);
+  void Sift_Down(int i);
 
-  // tree nodes without children are already in the correct order by definition
-  if (i > Size() / 2) {
-    return;
+  void Heapify() {
+    // walk trough the heap and reorder it from the bottom up
+    // but the leaves are already in the correct order
+    for (int i = (Size() - 2) / ARITY; i >= 0; i--) {
+      Sift_Down(i);
+    }
   }
 
-  // chek if left child is smaller than parent
-  if (l < Size() && heap[l] < heap[i]) {
-    smallest = l;
-  }
+  Compare comp;
+  vector<Slot, AlignedAllocator<Slot>> heap; // (priority, id) in heap order
+  vector<int32_t> pos;                       // heap index per id, -1 if popped
+  vector<V> value;                           // payload per id
+};
 
-  // chek if right child is smaller than parent
-  if (r < Size() && heap[r] < heap[smallest]) {
-    smallest = r;
+// move the hole up and fill it once at the end
+template <typename K, typename V, class Compare, int ARITY>
+void PriorityQueue<K, V, Compare, ARITY>::Sift_Up(int i) {
+  Slot item = At(i);
+  while (i > 0) {
+    int parent = (i - 1) / ARITY;
+    if (!comp(item.key, At(parent).key)) {
+      break;
+    }
+    At(i)         = At(parent);
+    pos[At(i).id] = i;
+    i             = parent;
   }
+  At(i)        = item;
+  pos[item.id] = i;
+}
 
-  // if either child was smaller, swap with parent and recurse on the child
-  if (smallest != i) {
-    swap(heap[i], heap[smallest]);
-    Min_Heapify(smallest);
+// -----------------------------------------------------------------------------
+template <typename K, typename V, class Compare, int ARITY>
+void PriorityQueue<K, V, Compare, ARITY>::Sift_Down(int i) {
+  Slot item = At(i);
+  int n     = Size();
+  while (true) {
+    int first = ARITY * i + 1;
+    if (first >= n) {
+      break;
+    }
+    // smallest of the (up to) ARITY children, they are next to each other
+    int best = first;
+    int end  = min(first + ARITY, n);
+    for (int c = first + 1; c < end; c++) {
+      if (comp(At(c).key, At(best).key)) {
+        best = c;
+      }
+    }
+    if (!comp(At(best).key, item.key)) {
+      break;
+    }
+    At(i)         = At(best);
+    pos[At(i).id] = i;
+    i             = best;
   }
-  return;
+  At(i)        = item;
+  pos[item.id] = i;
 }
 
 // Inserts a new key 'k'
-void PriorityQueue::Push(int k) {
-  heap.push_back(k); // insert new key at the end of the vector
-  int idx = heap.size() - 1;
-  // Fix the min heap property if it is violated by working our way up the tree
-  while (idx != 1 && heap[Parent(idx)] > heap[idx]) {
-    swap(heap[idx], heap[Parent(idx)]);
-    idx = Parent(idx);
+template <typename K, typename V, class Compare, int ARITY>
+int PriorityQueue<K, V, Compare, ARITY>::Push(const K& priority, const V& payload) {
+  int id = value.size();
+  value.push_back(payload);
+  heap.push_back(Slot{priority, id}); // insert new key at the end of the vector
+  pos.push_back(Size() - 1);
+  Sift_Up(Size() - 1);
+  return id;
+}
+
+// -----------------------------------------------------------------------------
+template <typename K, typename V, class Compare, int ARITY>
+bool PriorityQueue<K, V, Compare, ARITY>::Change_Priority(int id, const K& newPriority) {
+  if (!Contains(id)) {
+    return false;
+  }
+  int i         = pos[id];
+  bool moveUp   = comp(newPriority, At(i).key);
+  At(i).key     = newPriority;
+  // a smaller priority can only move the element up, a larger one only down
+  if (moveUp) {
+    Sift_Up(i);
+  } else {
+    Sift_Down(i);
   }
+  return true;
 }
 
-void PriorityQueue::Print() {
-  int div       = 1;
-  int inLinePos = 0;
+// -----------------------------------------------------------------------------
+// one line per level of the tree, groups of siblings separated by |
+template <typename K, typename V, class Compare, int ARITY>
+void PriorityQueue<K, V, Compare, ARITY>::Print() {
   cout << "Heap Visualization" << endl;
-  cout << 1 << ": ";
-  for (int i = 1; i < heap.size(); i++) {
-    if ((i % (div * 2)) == 0) {
-      cout << endl;
-      div *= 2;
-      cout << div << ": ";
-      inLinePos = 0;
-    }
-    cout << heap[i];
-    inLinePos++;
-    if (inLinePos > 0 && inLinePos % 2 == 0 && i >= 4) {
-      cout << " | ";
-    } else {
-      cout << " ";
+  int levelSize = 1;
+  for (int first = 0; first < Size(); first += levelSize, levelSize *= ARITY) {
+    cout << levelSize << ": ";
+    for (int i = first; i < min(first + levelSize, Size()); i++) {
+      cout << At(i).key;
+      if (levelSize > ARITY && (i - first) % ARITY == ARITY - 1) {
+        cout << " | ";
+      } else {
+        cout << " ";
+      }
     }
+    cout << endl;
   }
-  cout << endl;
 }
 
 // #############################################################################
@@ -188,6 +321,7 @@ public:
       conMap[i].resize(n, false);
       weightMap[i].resize(n, EdgeWeight::NO_CON);
     }
+    Reset_Stats();
     for (int x = 0; x < n; x++) {
       for (int y = x + 1; y < n; y++) {
         int rCon = rand() % 101; // rand number between 0 and 100
@@ -199,6 +333,8 @@ public:
           // unidirected graph, so we need to fill the other way too
           conMap[y][x]    = true;
           weightMap[y][x] = rWeight;
+          Count_Edge(x, +1);
+          Count_Edge(y, +1);
         }
       }
     }
@@ -231,8 +367,9 @@ public:
   // adds to G the edge from x to y
   // returns true if the edge was added, false if not added or already exists
   bool Add_Node(int x, int y) {
-    if ((x < n) && (y < n) && (x != y)) {
+    if ((x < n) && (y < n) && (x != y) && !conMap[x][y]) {
       conMap[x][y] = true;
+      Count_Edge(x, +1);
       return true;
     } else {
       return false;
@@ -240,8 +377,9 @@ public:
   }
   // removes the edge from x to y, if it is there.
   void Del_Node(int x, int y) {
-    if ((x < n) && (y < n)) {
+    if ((x < n) && (y < n) && conMap[x][y]) {
       conMap[x][y] = false;
+      Count_Edge(x, -1);
     }
     return;
   }
@@ -259,14 +397,54 @@ public:
 
   // void dijkstra(int start); // TODO
 
-  // set / get method declarations ---------------------------------------------
-  int Get_Num_Edges();
-  float Get_Density();
+  // set / get methods, statistics are kept up to date on every change --------
+  int Get_Num_Edges() {
+    return nEdges;
+  }
+
+  // number of edges leaving node x
+  int Get_Degree(int x) {
+    if (x < n) {
+      return degree[x];
+    } else {
+      return 0;
+    }
+  }
+
+  // number of nodes per degree, index == degree
+  const vector<int>& Get_Degree_Histogram() {
+    return degreeHist;
+  }
+
+  float Get_Density() {
+    // we don't allow self-loop
+    int64_t nPossibleEdges = static_cast<int64_t>(n) * (n - 1);
+    density = (nPossibleEdges > 0) ? static_cast<float>(nEdges) / nPossibleEdges : 0;
+    return density;
+  }
 
 private:
+  // clear the statistics of an empty graph with n nodes
+  void Reset_Stats() {
+    nEdges = 0;
+    degree.assign(n, 0);
+    degreeHist.assign(n + 1, 0);
+    degreeHist[0] = n;
+  }
+
+  // account for delta (+1/-1) edges leaving node x
+  void Count_Edge(int x, int delta) {
+    degreeHist[degree[x]]--;
+    degree[x] += delta;
+    degreeHist[degree[x]]++;
+    nEdges += delta;
+  }
+
   int n;                         // number of graph nodes / vertices
   int nEdges;                    // number of edges
   float density;                 // density of the graph
+  vector<int> degree;            // number of edges per node
+  vector<int> degreeHist;        // number of nodes per degree
   vector<vector<bool>> conMap;   // connectivity matrix
   vector<vector<int>> weightMap; // weight matrix, range 0-255
 };
@@ -294,29 +472,6 @@ void GraphMatrix::Print() {
   }
 }
 
-// -----------------------------------------------------------------------------
-// Setter / Getter Methods come here...
-// -----------------------------------------------------------------------------
-int GraphMatrix::Get_Num_Edges() {
-  nEdges = 0;
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) {
-      if (conMap[i][j]) {
-        nEdges++;
-      }
-    }
-  }
-  return nEdges;
-}
-
-// -----------------------------------------------------------------------------
-float GraphMatrix::Get_Density() {
-  int32_t nPossibleEdges = n * (n - 1); // we don't allow self-loop
-  nEdges                 = Get_Num_Edges();
-  density                = (static_cast<float>(nEdges) / nPossibleEdges);
-  return density;
-}
-
 // -----------------------------------------------------------------------------
 vector<int> GraphMatrix::Get_Neighbors(int x) {
   vector<int> neighbors;
@@ -404,6 +559,192 @@ void dijkstra(GraphMatrix G, int src) {
   printSolution(dist);
 }
 
+// Random mix of Push / Pop / Change_Priority, checked against a
+// std::priority_queue that drops outdated entries when they reach the top
+// returns the number of mismatches
+template <int ARITY>
+int Fuzz_Priority_Queue(int nOps, unsigned seed) {
+  typedef pair<int, int> Entry_t; // (priority, id)
+  priority_queue<Entry_t, vector<Entry_t>, greater<Entry_t>> refQueue;
+  vector<int> refKey;     // priority per id as the reference sees it
+  vector<bool> refAlive;  // id is still in the reference queue
+  int refSize = 0;
+  int nErrors = 0;
+  srand(seed);
+
+  // drop the entries of popped ids and of changed priorities
+  auto Ref_Top = [&]() -> int {
+    while (!refQueue.empty() && (!refAlive[refQueue.top().second] ||
+                                 refKey[refQueue.top().second] != refQueue.top().first)) {
+      refQueue.pop();
+    }
+    return refQueue.top().first;
+  };
+
+  PriorityQueue<int, int, less<int>, ARITY> queue;
+  for (int op = 0; op < nOps; op++) {
+    int kind     = rand() % 10;
+    int priority = rand() % 1000; // small range, so there are lots of ties
+    if (kind < 4 || refSize == 0) {
+      int id = queue.Push(priority, 3 * refKey.size() + 1);
+      if (id != static_cast<int>(refKey.size())) {
+        nErrors++;
+      }
+      refKey.push_back(priority);
+      refAlive.push_back(true);
+      refQueue.push(Entry_t(priority, id));
+      refSize++;
+    } else if (kind < 7) {
+      // ties may pop different ids, so the reference drops the id we popped
+      int expected = Ref_Top();
+      int id       = queue.Top_Id();
+      if (queue.Pop() != expected || !refAlive[id] || refKey[id] != expected) {
+        nErrors++;
+      }
+      refAlive[id] = false;
+      refSize--;
+    } else {
+      // ids of popped elements are picked as well and have to be rejected
+      int id = rand() % refKey.size();
+      if (queue.Change_Priority(id, priority) != refAlive[id]) {
+        nErrors++;
+      }
+      if (refAlive[id]) {
+        refKey[id] = priority;
+        refQueue.push(Entry_t(priority, id));
+      }
+    }
+    if (queue.Size() != refSize || (refSize > 0 && queue.Top() != Ref_Top())) {
+      nErrors++;
+    }
+    // the payload has to stay with its id while the heap is reordered
+    if (refSize > 0 && queue.Top_Value() != 3 * queue.Top_Id() + 1) {
+      nErrors++;
+    }
+  }
+  for (int id = 0; id < static_cast<int>(refKey.size()); id++) {
+    if (queue.Contains(id) != refAlive[id]) {
+      nErrors++;
+    }
+  }
+  // empty both queues, the priorities have to come out sorted
+  while (refSize > 0) {
+    int expected = Ref_Top();
+    int id       = queue.Top_Id();
+    if (queue.Pop() != expected || !refAlive[id]) {
+      nErrors++;
+    }
+    refAlive[id] = false;
+    refSize--;
+  }
+  return nErrors + queue.Size();
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark workload: push n random priorities, decrease n random ones and pop
+// everything. Times in ms for push / decrease / pop, the check sum over the
+// popped priorities has to be the same for every queue.
+struct Queue_Workload {
+  vector<int> keys;   // priority of the element with id i
+  vector<int> decIds; // element to decrease
+  vector<int> decBy;  // amount to decrease by, always >= 1
+};
+
+struct Queue_Times {
+  float push, decrease, pop;
+  uint64_t check;
+};
+
+inline float Elapsed_Ms(high_resolution_clock::time_point& start) {
+  auto now              = high_resolution_clock::now();
+  duration<float> delta = now - start;
+  start                 = now;
+  return delta.count() * 1000;
+}
+
+// -----------------------------------------------------------------------------
+template <int ARITY>
+Queue_Times Time_Priority_Queue(const Queue_Workload& w) {
+  Queue_Times t;
+  PriorityQueue<int, int, less<int>, ARITY> queue;
+  auto start = high_resolution_clock::now();
+  for (int i = 0; i < static_cast<int>(w.keys.size()); i++) {
+    queue.Push(w.keys[i], i);
+  }
+  t.push = Elapsed_Ms(start);
+  for (size_t i = 0; i < w.decIds.size(); i++) {
+    int id = w.decIds[i];
+    queue.Change_Priority(id, queue.Get_Priority(id) - w.decBy[i]);
+  }
+  t.decrease = Elapsed_Ms(start);
+  t.check    = 0;
+  while (!queue.Empty()) {
+    t.check = t.check * 31 + queue.Pop();
+  }
+  t.pop = Elapsed_Ms(start);
+  return t;
+}
+
+// -----------------------------------------------------------------------------
+// std::priority_queue has no decrease-key, a lower priority is pushed again
+// and outdated entries are skipped when they reach the top
+Queue_Times Time_Std_Priority_Queue(const Queue_Workload& w) {
+  typedef pair<int, int> Entry_t; // (priority, id)
+  Queue_Times t;
+  priority_queue<Entry_t, vector<Entry_t>, greater<Entry_t>> queue;
+  vector<int> current(w.keys);
+  auto start = high_resolution_clock::now();
+  for (int i = 0; i < static_cast<int>(w.keys.size()); i++) {
+    queue.push(Entry_t(w.keys[i], i));
+  }
+  t.push = Elapsed_Ms(start);
+  for (size_t i = 0; i < w.decIds.size(); i++) {
+    int id = w.decIds[i];
+    current[id] -= w.decBy[i];
+    queue.push(Entry_t(current[id], id));
+  }
+  t.decrease = Elapsed_Ms(start);
+  t.check    = 0;
+  while (!queue.empty()) {
+    Entry_t top = queue.top();
+    queue.pop();
+    if (top.first == current[top.second]) {
+      t.check = t.check * 31 + top.first;
+    }
+  }
+  t.pop = Elapsed_Ms(start);
+  return t;
+}
+
+// -----------------------------------------------------------------------------
+void Benchmark_Priority_Queue(int n) {
+  Queue_Workload w;
+  srand(42);
+  for (int i = 0; i < n; i++) {
+    w.keys.push_back(rand() % (1 << 30));
+    w.decIds.push_back(rand() % n);
+    w.decBy.push_back(rand() % 1000 + 1);
+  }
+
+  cout << "########## Priority Queue Benchmark ##########" << endl;
+  cout << "times in ms, " << n << " elements" << endl;
+  cout << setw(22) << "queue" << setw(10) << "push" << setw(10) << "decrease" << setw(10)
+       << "pop" << setw(10) << "total" << setw(8) << "check" << endl;
+  uint64_t reference = 0;
+  auto Print_Row     = [&](const char* name, const Queue_Times& t) {
+    if (reference == 0) {
+      reference = t.check;
+    }
+    cout << setw(22) << name << setw(10) << t.push << setw(10) << t.decrease << setw(10)
+         << t.pop << setw(10) << (t.push + t.decrease + t.pop) << setw(8)
+         << ((t.check == reference) ? "ok" : "FAILED") << endl;
+  };
+  Print_Row("std::priority_queue", Time_Std_Priority_Queue(w));
+  Print_Row("PriorityQueue ARITY 2", Time_Priority_Queue<2>(w));
+  Print_Row("PriorityQueue ARITY 4", Time_Priority_Queue<4>(w));
+  Print_Row("PriorityQueue ARITY 8", Time_Priority_Queue<8>(w));
+}
+
 // float GraphMatrix::Get_Density(void) {
 //   return static_cast<float>(nNodes * (nNodes - 1)) / 2.0f;
 // }
@@ -430,7 +771,27 @@ void dijkstra(GraphMatrix G, int src) {
 //   // create a vector of vectors of int
 // }
 
-int main() {
+int main(int argc, char** argv) {
+
+  // usage: main_full --fuzz-queue [rounds]
+  if ((argc >= 2) && (string(argv[1]) == "--fuzz-queue")) {
+    int nRounds = (argc >= 3) ? atoi(argv[2]) : 100;
+    int nErrors = 0;
+    for (int round = 0; round < nRounds; round++) {
+      nErrors += Fuzz_Priority_Queue<2>(10000, round);
+      nErrors += Fuzz_Priority_Queue<4>(10000, round);
+      nErrors += Fuzz_Priority_Queue<8>(10000, round);
+    }
+    cout << "PriorityQueue fuzz: " << nRounds << " rounds of 10000 ops, " << nErrors
+         << " errors" << endl;
+    return (nErrors == 0) ? 0 : 1;
+  }
+
+  // usage: main_full --bench-queue [elements]
+  if ((argc >= 2) && (string(argv[1]) == "--bench-queue")) {
+    Benchmark_Priority_Queue((argc >= 3) ? atoi(argv[2]) : 1000000);
+    return 0;
+  }
 
   auto startTime = high_resolution_clock::now();
 
@@ -461,7 +822,7 @@ int main() {
   for (int i = 0; i < N_ELEM; i++) {
     unsortedVector[i] = rand() % 100;
   }
-  PriorityQueue MyQueue(unsortedVector);
+  PriorityQueue<int> MyQueue(unsortedVector);
   MyQueue.Print();
 
   MyQueue.Push(5);
@@ -476,14 +837,11 @@ int main() {
   MyQueue.Pop();
   MyQueue.Print();
 
-  MyQueue.Change_Prioirity(0, 250);
-  MyQueue.Change_Prioirity(0, 250);
-  MyQueue.Change_Prioirity(0, 250);
+  // ids are given in insertion order, the popped ids are gone
+  MyQueue.Change_Priority(MyQueue.Top_Id(), 250);
   MyQueue.Print();
 
-  MyQueue.Change_Prioirity(5, 0);
-  MyQueue.Change_Prioirity(5, 0);
-  MyQueue.Change_Prioirity(5, 0);
+  MyQueue.Change_Priority(5, 0);
   MyQueue.Print();
 
   cout << "#######################################################" << endl;
@@ -4,6 +4,12 @@
 #include<map>
 #include<ctime>
 #include<cstdlib>
+#include<cstring>
+#include<fstream>
+#include<queue>
+#include<thread>
+#include<algorithm>
+#include<functional>
 using namespace std;
 
 //==============================================================================
@@ -45,6 +51,55 @@ struct strNode
   list<Node> edges;	
 };
 
+//==============================================================================
+// Neighbor definitions
+// A neighbor of a node and the weight of the edge leading to it
+// NeighborRange walks the edge list of a node without copying it, e.g.
+// for (Neighbor n : g.neighborRange('A')) ... 
+//==============================================================================
+struct strNeighbor
+{
+  char name;	// Node name of the neighbor
+  int weight;	// Weight of the edge to the neighbor
+};
+typedef struct strNeighbor Neighbor;
+
+class NeighborRange
+{
+  public:
+    class iterator
+    {
+      public:
+        iterator(list<Node>::const_iterator pos, const vector<char>* names) : pos(pos), names(names) {}
+        Neighbor operator*() const
+        {
+          Neighbor n = {(*names)[(*pos).number], (*pos).weight};
+          return n;
+        }
+        iterator& operator++()
+        {
+          ++pos;
+          return *this;
+        }
+        bool operator!=(const iterator& other) const
+        {
+          return pos != other.pos;
+        }
+
+      private:
+        list<Node>::const_iterator pos;	// Current edge in the edge list
+        const vector<char>* names;	// Map node numbers into node names
+    };
+
+    NeighborRange(list<Node>::const_iterator first, list<Node>::const_iterator last, const vector<char>* names) : first(first), last(last), names(names) {}
+    iterator begin() const { return iterator(first, names); }
+    iterator end() const { return iterator(last, names); }
+
+  private:
+    list<Node>::const_iterator first, last;	// Edge list of the node
+    const vector<char>* names;		// Map node numbers into node names
+};
+
 //==============================================================================
 // Graph Class
 // Represent a Graph through an adjacency list
@@ -60,6 +115,7 @@ class Graph
     void set_edge_value(char x, char y, int value);
     bool adjacent(char x, char y);
     list<char> neighbors(char x);
+    NeighborRange neighborRange(char x) const;
     int V();
     int E();
     list<char> vertices();
@@ -220,18 +276,23 @@ bool Graph::adjacent(char x, char y)
 list<char> Graph::neighbors(char x)
 {
   list<char> adjNodes;
-  for(list<Node>::iterator i=adjList.begin(); i != adjList.end(); ++i)
-  {
-    if ((*i).number==nodeNumbers[x])
-    {
-      for(list<Node>::iterator j=(*i).edges.begin(); j != (*i).edges.end(); ++j)
-      {
-	adjNodes.push_back(nodeNames[(*j).number]);
-      }
-    }
-  }
+  for (Neighbor n : neighborRange(x))
+    adjNodes.push_back(n.name);
   return adjNodes;
 }
+
+// Return the neighbors of 'x' with edge weights, nothing is copied
+// The range is valid until the edges of 'x' are changed
+NeighborRange Graph::neighborRange(char x) const
+{
+  static const list<Node> noEdges;
+  map<char, int>::const_iterator number = nodeNumbers.find(x);
+  if (number != nodeNumbers.end())
+    for(list<Node>::const_iterator i=adjList.begin(); i != adjList.end(); ++i)
+      if ((*i).number==(*number).second)
+	return NeighborRange((*i).edges.begin(), (*i).edges.end(), &nodeNames);
+  return NeighborRange(noEdges.end(), noEdges.end(), &nodeNames);
+}
    
 // Return the number of nodes in the Graph
 int Graph::V()
@@ -414,6 +475,18 @@ int PriorityQueue::size()
   return pq.size();
 }
 
+//==============================================================================
+// PathInfo Definitions
+// Result of a point-to-point query: the path, its cost and the search effort
+//==============================================================================
+struct strPathInfo
+{
+  list<char> path;	// Nodes of the shortest path, empty if unreachable
+  int cost;		// Sum of the edge weights of path, INFINIT if unreachable
+  int settled;		// Number of nodes taken from the priority queues
+};
+typedef struct strPathInfo PathInfo;
+
 //==============================================================================
 // ShortestPath Class
 // Implements Dijkstra's Algorithm to find shortest paths between two nodes
@@ -425,6 +498,7 @@ class ShortestPath
     ShortestPath(Graph g);
     list<char> path(char u, char w);
     int path_size(char u, char w);
+    PathInfo query(char u, char w, bool bidirectional);
   
   private:
     Graph graph;		// Graph used by Diajkstra's Algorithm
@@ -444,71 +518,563 @@ ShortestPath::ShortestPath(Graph g)
 // Return a list<char> containing the list of nodes in the shortest path between 'u' and 'w'
 list<char> ShortestPath::path(char u, char w)
 {
-  // Initialize candidates list with all nodes
-  list<char> candidates = graph.vertices(), desiredPath;
-  list<NodeInfo> minPaths;
-  PriorityQueue p;
-  NodeInfo lastSelected, n;
-     
-  // Calculate shortest path from 'u' to 'w' (Dijkstra's Algorithm)
-  candidates.remove(u);			// Remove 'u' from candidates list
-  lastSelected.nodeName = u;		// Set 'u' as lastSelected
-  lastSelected.minDist = 0;
-  lastSelected.through = u;
-  minPaths.push_back(lastSelected);	// Add 'u' to minPath list
-  while ((!candidates.empty()) && (lastSelected.nodeName !=w))
+  return query(u, w, true).path;
+}
+
+// Return the size of the shortest path between 'u' and 'w'
+int ShortestPath::path_size(char u, char w)
+{
+  return query(u, w, true).cost;
+}
+
+// Find the shortest path between 'u' and 'w' and its cost with one search
+// Bidirectional: a forward search from 'u' and a backward search from 'w' (the
+// graph is undirected) take turns, always the one with the closer top node.
+// mu is the shortest u-w path seen so far through a node reached by both.
+// Once topForward + topBackward >= mu no shorter path can be found, each
+// search has only covered about half the distance -> about half the nodes.
+// One-way: only the forward search runs, the backward one just holds 'w', so
+// it stops as soon as 'w' is the closest node (plain Dijkstra).
+PathInfo ShortestPath::query(char u, char w, bool bidirectional)
+{
+  PathInfo result;
+  result.cost = INFINIT;
+  result.settled = 0;
+  if (u == w)
+  {
+    result.path.push_back(u);
+    result.cost = 0;
+    return result;
+  }
+
+  // Per search (0 forward, 1 backward), indexed by node name
+  vector<int> dist[2];		// Shortest distance found so far
+  vector<char> through[2];	// Node that precede it on that path
+  vector<bool> settled[2];	// Distance is final
+  PriorityQueue p[2];
+  for (int s=0; s<2; ++s)
+  {
+    dist[s].assign(256, INFINIT);
+    through[s].assign(256, ' ');
+    settled[s].assign(256, false);
+  }
+  NodeInfo start = {u, 0, u}, goal = {w, 0, w};
+  dist[0][static_cast<unsigned char>(u)] = 0;
+  dist[1][static_cast<unsigned char>(w)] = 0;
+  p[0].insert(start);
+  p[1].insert(goal);
+
+  int mu = INFINIT;
+  char meet = ' ';		// Node in the middle of the best path
+  while ((p[0].size() > 0) && (p[1].size() > 0))
+  {
+    if (p[0].top().minDist + p[1].top().minDist >= mu)
+      break;
+    int s = (!bidirectional || (p[0].top().minDist <= p[1].top().minDist)) ? 0 : 1;
+    NodeInfo x = p[s].top();
+    p[s].minPriority();
+    settled[s][static_cast<unsigned char>(x.nodeName)] = true;
+    result.settled++;
+
+    for (Neighbor nb : graph.neighborRange(x.nodeName))
+    {
+      unsigned char y = static_cast<unsigned char>(nb.name);
+      if (settled[s][y])
+	continue;
+      NodeInfo n = {nb.name, x.minDist + nb.weight, x.nodeName};
+      if (n.minDist < dist[s][y])
+      {
+	if (!p[s].contains(n))
+	  p[s].insert(n);
+	else
+	  p[s].chgPriority(n);
+	dist[s][y] = n.minDist;
+	through[s][y] = x.nodeName;
+      }
+      // 'y' was reached from the other side too -> candidate for mu
+      if ((dist[1-s][y] != INFINIT) && (dist[s][y] + dist[1-s][y] < mu))
+      {
+	mu = dist[s][y] + dist[1-s][y];
+	meet = nb.name;
+      }
+    }
+  }
+
+  // Return an empty path if 'w' can't be reached
+  if (mu == INFINIT)
+    return result;
+
+  // Go backward from 'meet' to 'u' and forward from 'meet' to 'w'
+  result.cost = mu;
+  result.path.push_back(meet);
+  for (char x = meet; x != u; x = through[0][static_cast<unsigned char>(x)])
+    result.path.push_front(through[0][static_cast<unsigned char>(x)]);
+  for (char x = meet; x != w; x = through[1][static_cast<unsigned char>(x)])
+    result.path.push_back(through[1][static_cast<unsigned char>(x)]);
+  return result;
+}
+
+//==============================================================================
+// ContractionHierarchy Class
+// Preprocesses a Graph that doesn't change any more, so that each query only
+// looks at a few nodes. Nodes are contracted (taken out of the graph) least
+// important first. For every two neighbors of a contracted node a shortcut
+// edge is added, unless a witness search finds a path between them that isn't
+// longer than the one through the node.
+// Importance: shortcuts needed minus edges removed (edge difference) plus the
+// number of neighbors contracted already, which spreads the work over the graph.
+// Every round contracts the nodes less important than all their neighbors.
+// These don't touch each other and their witness searches avoid all of them,
+// so the searches of a round run in threads.
+// A query searches upward (only to later contracted nodes) from both ends, the
+// shortest path leads over the highest node both searches reach.
+// A shortcut knows the node it skips, so the path is unpacked recursively.
+//==============================================================================
+struct strCHEdge
+{
+  int to;	// Node number at the other end
+  int weight;	// Edge weight, for a shortcut the sum of the skipped edges
+  int middle;	// Node skipped by a shortcut, -1 for an edge of the graph
+};
+typedef struct strCHEdge CHEdge;
+
+// Magic number at the beginning of a contraction hierarchy file
+const char CH_FILE_MAGIC[8] = {'C','H','I','E','R','1','\0','\0'};
+
+// Witness searches give up after settling this many nodes (the shortcut is
+// then added, which is never wrong, only maybe not needed)
+const int CH_WITNESS_LIMIT = 64;
+
+class ContractionHierarchy
+{
+  public:
+    ContractionHierarchy();
+    ContractionHierarchy(Graph g, int numThreads);
+    list<char> path(char u, char w);
+    int path_size(char u, char w);
+    PathInfo query(char u, char w);
+    int shortcuts();
+    bool save(const char* fileName);
+    bool load(const char* fileName);
+
+  private:
+    void findShortcuts(int v, const vector< map<int,CHEdge> >& adj, const vector<bool>& skip, vector< pair<int,CHEdge> >& found);
+    void unpack(int x, int y, list<char>& path);
+    int number(char x);
+
+    int numV;				// Number of nodes of the Graph
+    vector<char> nodeNames;		// Map node numbers into node names
+    vector<int> rank;			// Position of every node in the contraction order
+    vector< vector<CHEdge> > up;	// Edges and shortcuts to nodes contracted later
+};
+
+// Run work(i) for i=0..count-1 on numThreads threads
+template <class Work>
+void runParallel(int numThreads, int count, Work work)
+{
+  vector<thread> threads;
+  for (int t=0; t<numThreads; ++t)
+    threads.push_back(thread([=, &work]()
+    {
+      for (int i=t; i<count; i+=numThreads)
+	work(i);
+    }));
+  for (thread& t : threads)
+    t.join();
+}
+
+// Constructor of ContractionHierarchy Class (empty hierarchy)
+ContractionHierarchy::ContractionHierarchy()
+{
+  numV = 0;
+}
+
+// Constructor of ContractionHierarchy Class that contracts all nodes of 'g'
+// numThreads=0 uses one thread per core
+ContractionHierarchy::ContractionHierarchy(Graph g, int numThreads=0)
+{
+  if (numThreads <= 0)
+    numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+
+  // Remaining graph, adj[x] maps a neighbor to the edge leading to it
+  numV = g.V();
+  nodeNames.resize(numV);
+  map<char, int> numbers;
+  for (int x=0; x<numV; ++x)
+  {
+    nodeNames[x] = g.get_node_value(x);
+    numbers[nodeNames[x]] = x;
+  }
+  vector< map<int,CHEdge> > adj(numV);
+  for (int x=0; x<numV; ++x)
+    for (Neighbor nb : g.neighborRange(nodeNames[x]))
+    {
+      CHEdge e = {numbers[nb.name], nb.weight, -1};
+      adj[x][e.to] = e;
+    }
+
+  rank.assign(numV, -1);
+  up.assign(numV, vector<CHEdge>());
+  vector<bool> removed(numV, false);
+  vector<int> contractedNeighbors(numV, 0);
+  vector<int> remaining;
+  for (int x=0; x<numV; ++x)
+    remaining.push_back(x);
+  int nextRank = 0;
+  while (! remaining.empty())
   {
-    // For each node in candidate list calculate the cost to reach that candidate through lastSelected 
-    for(list<char>::iterator i=candidates.begin(); i != candidates.end(); ++i)
+    // Importance of all remaining nodes
+    vector<int> importance(numV, 0);
+    runParallel(numThreads, remaining.size(), [&](int i)
     {
-      n.nodeName=*i;
-      n.minDist=lastSelected.minDist+graph.get_edge_value(lastSelected.nodeName,*i);
-      n.through=lastSelected.nodeName;
-      if (!p.contains(n))	// Add candidate to priority queue if doesn't exist 
-	p.insert(n);
+      int v = remaining[i];
+      vector< pair<int,CHEdge> > found;
+      findShortcuts(v, adj, removed, found);
+      importance[v] = static_cast<int>(found.size()) - static_cast<int>(adj[v].size()) +
+        contractedNeighbors[v];
+    });
+
+    // Nodes less important than all their neighbors (ties: lower number)
+    vector<int> round, next;
+    vector<bool> skip = removed;
+    for (int v : remaining)
+    {
+      bool lowest = true;
+      for (const pair<const int,CHEdge>& e : adj[v])
+	if ((importance[e.first] < importance[v]) || ((importance[e.first] == importance[v]) && (e.first < v)))
+	  lowest = false;
+      if (lowest)
+      {
+	round.push_back(v);
+	skip[v] = true;
+      }
       else
-	if (p.isBetter(n))	// Update candidate minDist in priority queue if a better path was found
-	  p.chgPriority(n);
+	next.push_back(v);
+    }
+
+    // Shortcuts of the round, the witness searches avoid all its nodes
+    vector< vector< pair<int,CHEdge> > > found(round.size());
+    runParallel(numThreads, round.size(), [&](int i)
+    {
+      findShortcuts(round[i], adj, skip, found[i]);
+    });
+
+    // Take the nodes out, keep their edges as upward edges of the hierarchy
+    for (size_t i=0; i<round.size(); ++i)
+    {
+      int v = round[i];
+      rank[v] = nextRank++;
+      for (const pair<const int,CHEdge>& e : adj[v])
+      {
+	up[v].push_back(e.second);
+	adj[e.first].erase(v);
+	contractedNeighbors[e.first]++;
+      }
+      adj[v].clear();
+      removed[v] = true;
     }
-    lastSelected = p.top();			// Select the candidate with minDist from priority queue
-    p.minPriority();				// Remove it from the priority queue
-    minPaths.push_back(lastSelected);		// Add the candidate with min distance to minPath list
-    candidates.remove(lastSelected.nodeName);	// Remove it from candidates list
+    for (size_t i=0; i<round.size(); ++i)
+      for (const pair<int,CHEdge>& s : found[i])
+      {
+	map<int,CHEdge>::iterator e = adj[s.first].find(s.second.to);
+	if ((e == adj[s.first].end()) || (s.second.weight < (*e).second.weight))
+	{
+	  CHEdge back = {s.first, s.second.weight, s.second.middle};
+	  adj[s.first][s.second.to] = s.second;
+	  adj[s.second.to][s.first] = back;
+	}
+      }
+    remaining.swap(next);
   }
-  
-  // Go backward from 'w' to 'u' adding nodes in that path to desiredPath list
-  lastSelected=minPaths.back();
-  desiredPath.push_front(lastSelected.nodeName);
-  while(lastSelected.nodeName!=u)
+}
+
+// Shortcuts needed to contract 'v' (as pairs of node and edge) if the nodes in 'skip' are gone
+// From every neighbor 'u' a Dijkstra search looks for paths to the neighbors behind it
+void ContractionHierarchy::findShortcuts(int v, const vector< map<int,CHEdge> >& adj, const vector<bool>& skip, vector< pair<int,CHEdge> >& found)
+{
+  typedef pair<int,int> Item;	// Distance and node number
+  found.clear();
+  int maxEdge = 0;
+  for (const pair<const int,CHEdge>& e : adj[v])
+    maxEdge = max(maxEdge, e.second.weight);
+
+  map<int,int> dist;		// Distances found by the current search
+  for (map<int,CHEdge>::const_iterator u=adj[v].begin(); u != adj[v].end(); ++u)
   {
-    for(list<NodeInfo>::iterator i=minPaths.begin(); i != minPaths.end(); ++i)
-      if ((*i).nodeName==lastSelected.through)
+    if (skip[(*u).first])
+      continue;
+    int maxDist = (*u).second.weight + maxEdge;
+    dist.clear();
+    dist[(*u).first] = 0;
+    priority_queue<Item, vector<Item>, greater<Item> > p;
+    p.push(Item(0, (*u).first));
+    int settled = 0;
+    while (! p.empty() && (settled < CH_WITNESS_LIMIT))
+    {
+      Item x = p.top();
+      p.pop();
+      if ((x.first != dist[x.second]) || (x.first > maxDist))
+	continue;
+      settled++;
+      for (const pair<const int,CHEdge>& e : adj[x.second])
+      {
+	if ((e.first == v) || skip[e.first])
+	  continue;
+	int d = x.first + e.second.weight;
+	map<int,int>::iterator old = dist.find(e.first);
+	if ((old == dist.end()) || (d < (*old).second))
+	{
+	  dist[e.first] = d;
+	  p.push(Item(d, e.first));
+	}
+      }
+    }
+
+    // Every pair once: only the neighbors after 'u'
+    map<int,CHEdge>::const_iterator w = u;
+    for (++w; w != adj[v].end(); ++w)
+    {
+      if (skip[(*w).first])
+	continue;
+      int viaV = (*u).second.weight + (*w).second.weight;
+      map<int,int>::iterator witness = dist.find((*w).first);
+      if ((witness == dist.end()) || ((*witness).second > viaV))
       {
-	lastSelected=(*i);
-	desiredPath.push_front(lastSelected.nodeName);
+	CHEdge shortcut = {(*w).first, viaV, v};
+	found.push_back(make_pair((*u).first, shortcut));
       }
+    }
   }
-  return desiredPath;
+}
+
+// Return a list<char> containing the list of nodes in the shortest path between 'u' and 'w'
+list<char> ContractionHierarchy::path(char u, char w)
+{
+  return query(u, w).path;
 }
 
 // Return the size of the shortest path between 'u' and 'w'
-int ShortestPath::path_size(char u, char w)
+int ContractionHierarchy::path_size(char u, char w)
 {
-  int pathCost=0;
-  list<char> sp;
-  char current,next;
-  
-  // Calculate the shortest path from 'u' to 'w' and then sum up edge weights in this path
-  sp = path(u,w);
-  current=sp.front();
-  sp.pop_front();
-  for(list<char>::iterator i=sp.begin(); i!=sp.end(); ++i)
+  return query(u, w).cost;
+}
+
+// Find the shortest path between 'u' and 'w' and its cost
+// Both upward searches take turns, always the one with the closer top node.
+// A search stops once its top node is not closer than mu, the best path over
+// a node settled by both.
+PathInfo ContractionHierarchy::query(char u, char w)
+{
+  typedef pair<int,int> Item;	// Distance and node number
+  PathInfo result;
+  result.cost = INFINIT;
+  result.settled = 0;
+  int from = number(u), to = number(w);
+  if ((from < 0) || (to < 0))
+    return result;
+
+  // Per search (0 forward, 1 backward), indexed by node number
+  vector<int> dist[2];		// Shortest distance found so far
+  vector<int> through[2];	// Node that precede it on that path
+  priority_queue<Item, vector<Item>, greater<Item> > p[2];
+  for (int s=0; s<2; ++s)
+  {
+    dist[s].assign(numV, INFINIT);
+    through[s].assign(numV, -1);
+  }
+  dist[0][from] = 0;
+  dist[1][to] = 0;
+  p[0].push(Item(0, from));
+  p[1].push(Item(0, to));
+
+  int mu = INFINIT;
+  int meet = -1;
+  while (! p[0].empty() || ! p[1].empty())
+  {
+    int s = (p[1].empty() || (! p[0].empty() && (p[0].top().first <= p[1].top().first))) ? 0 : 1;
+    Item x = p[s].top();
+    p[s].pop();
+    if (x.first != dist[s][x.second])
+      continue;			// A shorter path to the node was found later
+    if (x.first >= mu)
+    {
+      p[s] = priority_queue<Item, vector<Item>, greater<Item> >();
+      continue;
+    }
+    result.settled++;
+    if ((dist[1-s][x.second] != INFINIT) && (x.first + dist[1-s][x.second] < mu))
+    {
+      mu = x.first + dist[1-s][x.second];
+      meet = x.second;
+    }
+    // Stall-on-demand: a higher node reached already has a shorter path down
+    // to this one, so no shortest path goes up from here
+    bool stalled = false;
+    for (const CHEdge& e : up[x.second])
+      if ((dist[s][e.to] != INFINIT) && (dist[s][e.to] + e.weight < x.first))
+	stalled = true;
+    if (stalled)
+      continue;
+    for (const CHEdge& e : up[x.second])
+      if (x.first + e.weight < dist[s][e.to])
+      {
+	dist[s][e.to] = x.first + e.weight;
+	through[s][e.to] = x.second;
+	p[s].push(Item(dist[s][e.to], e.to));
+      }
+  }
+
+  // Return an empty path if 'w' can't be reached
+  if (mu == INFINIT)
+    return result;
+
+  // Nodes of the hierarchy from 'u' up to 'meet' and down to 'w', then every
+  // edge between them unpacked
+  list<int> nodes;
+  nodes.push_back(meet);
+  for (int x = meet; x != from; x = through[0][x])
+    nodes.push_front(through[0][x]);
+  for (int x = meet; x != to; x = through[1][x])
+    nodes.push_back(through[1][x]);
+  result.cost = mu;
+  result.path.push_back(u);
+  for (list<int>::iterator i=nodes.begin(), j=++nodes.begin(); j != nodes.end(); ++i, ++j)
+    unpack(*i, *j, result.path);
+  return result;
+}
+
+// Append the nodes of the edge or shortcut from 'x' to 'y' (without 'x') to path
+void ContractionHierarchy::unpack(int x, int y, list<char>& path)
+{
+  // The edge is kept by the node contracted first
+  int low = (rank[x] < rank[y]) ? x : y;
+  int high = (low == x) ? y : x;
+  for (const CHEdge& e : up[low])
+    if (e.to == high)
+    {
+      if (e.middle < 0)
+	path.push_back(nodeNames[y]);
+      else
+      {
+	unpack(x, e.middle, path);
+	unpack(e.middle, y, path);
+      }
+      return;
+    }
+}
+
+// Return the number of shortcuts added by the contraction
+int ContractionHierarchy::shortcuts()
+{
+  int count = 0;
+  for (int x=0; x<numV; ++x)
+    for (const CHEdge& e : up[x])
+      if (e.middle >= 0)
+	count++;
+  return count;
+}
+
+// Return the number of the node named 'x', -1 if there is none
+int ContractionHierarchy::number(char x)
+{
+  for (int i=0; i<numV; ++i)
+    if (nodeNames[i] == x)
+      return i;
+  return -1;
+}
+
+// Write the hierarchy into a binary file
+// Layout (all int in the byte order of this machine): CH_FILE_MAGIC, numV,
+// then per node: name (char), rank, number of upward edges, edges (to, weight, middle)
+bool ContractionHierarchy::save(const char* fileName)
+{
+  ofstream file(fileName, ios::binary | ios::trunc);
+  if (! file.is_open())
+  {
+    cout << "Error opening file " << fileName << endl;
+    return false;
+  }
+  file.write(CH_FILE_MAGIC, sizeof(CH_FILE_MAGIC));
+  file.write(reinterpret_cast<const char*>(&numV), sizeof(numV));
+  for (int x=0; x<numV; ++x)
+  {
+    int count = up[x].size();
+    file.write(&nodeNames[x], sizeof(char));
+    file.write(reinterpret_cast<const char*>(&rank[x]), sizeof(int));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const CHEdge& e : up[x])
+    {
+      file.write(reinterpret_cast<const char*>(&e.to), sizeof(int));
+      file.write(reinterpret_cast<const char*>(&e.weight), sizeof(int));
+      file.write(reinterpret_cast<const char*>(&e.middle), sizeof(int));
+    }
+  }
+  return file.good();
+}
+
+// Read a hierarchy written by save(), the hierarchy is empty if it fails
+bool ContractionHierarchy::load(const char* fileName)
+{
+  ifstream file(fileName, ios::binary);
+  if (! file.is_open())
+  {
+    cout << "Error opening file " << fileName << endl;
+    return false;
+  }
+  char magic[sizeof(CH_FILE_MAGIC)];
+  numV = 0;
+  if (! file.read(magic, sizeof(magic)) || (memcmp(magic, CH_FILE_MAGIC, sizeof(magic)) != 0) || ! file.read(reinterpret_cast<char*>(&numV), sizeof(numV)) || (numV < 0) || (numV > 256))
+  {
+    cout << "Error: " << fileName << " is not a contraction hierarchy file" << endl;
+    numV = 0;
+    return false;
+  }
+  nodeNames.assign(numV, ' ');
+  rank.assign(numV, -1);
+  up.assign(numV, vector<CHEdge>());
+  bool ok = true;
+  for (int x=0; ok && (x<numV); ++x)
+  {
+    int count = 0;
+    ok = file.read(&nodeNames[x], sizeof(char)) && file.read(reinterpret_cast<char*>(&rank[x]), sizeof(int)) && file.read(reinterpret_cast<char*>(&count), sizeof(count)) && (rank[x] >= 0) && (rank[x] < numV) && (count >= 0) && (count < numV);
+    for (int i=0; ok && (i<count); ++i)
+    {
+      CHEdge e;
+      ok = file.read(reinterpret_cast<char*>(&e.to), sizeof(int)) && file.read(reinterpret_cast<char*>(&e.weight), sizeof(int)) && file.read(reinterpret_cast<char*>(&e.middle), sizeof(int)) && (e.to >= 0) && (e.to < numV) && (e.middle >= -1) && (e.middle < numV);
+      up[x].push_back(e);
+    }
+  }
+  // Edges lead upward and shortcuts skip a lower node, so unpack() ends
+  for (int x=0; ok && (x<numV); ++x)
+    for (const CHEdge& e : up[x])
+      if ((rank[e.to] <= rank[x]) || ((e.middle >= 0) && (rank[e.middle] >= rank[x])))
+	ok = false;
+  if (! ok)
+  {
+    cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+    numV = 0;
+    nodeNames.clear();
+    rank.clear();
+    up.clear();
+    return false;
+  }
+  return true;
+}
+
+// Return the sum of the edge weights along 'path', INFINIT for an empty path
+// or if two nodes in a row aren't neighbors
+int pathCost(Graph& g, list<char> path)
+{
+  if (path.empty())
+    return INFINIT;
+  int cost = 0;
+  for (list<char>::iterator i=path.begin(), j=++path.begin(); j != path.end(); ++i, ++j)
   {
-    next = (*i);
-    pathCost += graph.get_edge_value(current,next);
-    current = next;
+    if (! g.adjacent(*i, *j))
+      return INFINIT;
+    cost += g.get_edge_value(*i, *j);
   }
-  return pathCost; 
+  return cost;
 }
 
 //==============================================================================
@@ -520,7 +1086,7 @@ class MonteCarlo
   public:
     MonteCarlo();
     Graph randomGraph(int vert, double density, int minDistEdge, int maxDistEdge);
-    void run(Graph g);
+    void run(Graph g, const char* chFile);
   
   private:
 };
@@ -557,7 +1123,9 @@ Graph MonteCarlo::randomGraph(int numVert, double density, int minDistEdge, int
 }
 
 // Run a simulation finding the shortest paths in a given graph 
-void MonteCarlo::run(Graph g)
+// The paths are also found with a contraction hierarchy, which is written to
+// 'chFile' and read back from there if a file name is given
+void MonteCarlo::run(Graph g, const char* chFile=NULL)
 {
   static int turn=0;
   
@@ -574,13 +1142,25 @@ void MonteCarlo::run(Graph g)
   list<char> v = g.vertices();
   cout << endl << "Vertices: " << v << endl; 
   int reachVert=0, sumPathSize=0, avgPathSize=0;
+  int settledOneWay=0, settledBidirectional=0, settledCH=0;
+  bool sameCH=true;
   ShortestPath sp(g);
+  ContractionHierarchy ch(g);
+  if (chFile != NULL && (! ch.save(chFile) || ! ch.load(chFile)))
+    return;
   for (list<char>::iterator i=++v.begin(); i != v.end(); ++i) 
   {
     char src = v.front();
     char dst = (*i);
-    list<char> p = sp.path(src,dst);
-    int ps = sp.path_size(src,dst);
+    PathInfo info = sp.query(src,dst,true);	// Path and its cost from one search
+    list<char> p = info.path;
+    int ps = info.cost;
+    settledBidirectional += info.settled;
+    settledOneWay += sp.query(src,dst,false).settled;
+    PathInfo chInfo = ch.query(src,dst);
+    settledCH += chInfo.settled;
+    if ((chInfo.cost != ps) || (pathCost(g, chInfo.path) != ps))
+      sameCH = false;
     if (ps != INFINIT)
       cout << "ShortestPath (" << src << " to " << dst << "): " << ps << " -> " << p << endl;
     else
@@ -598,23 +1178,27 @@ void MonteCarlo::run(Graph g)
   else
     avgPathSize = 0;
   cout << endl << "AVG ShortestPath Size (reachVert: " << reachVert << " - sumPathSize: " << sumPathSize << "): " << avgPathSize << endl;
+  cout << "Settled nodes (one-way: " << settledOneWay << " - bidirectional: " << settledBidirectional << " - contraction hierarchy: " << settledCH << ")" << endl;
+  cout << "Contraction hierarchy: " << ch.shortcuts() << " shortcuts, " << (sameCH ? "same paths" : "Error: the paths differ") << endl;
 }
 
 //==============================================================================
 // Main Function
 //==============================================================================
-int main()
+// Optional: file name to write the contraction hierarchies to
+int main(int argc, char* argv[])
 {
+  const char* chFile = (argc == 2) ? argv[1] : NULL;
   MonteCarlo simulation;
   Graph g;
   
   // Creates a graph with 50 nodes / density 20% and then run simulation
   g = simulation.randomGraph(50,0.2,1,10);
-  simulation.run(g);
+  simulation.run(g, chFile);
 
   // Creates a graph with 50 nodes / density 40% and then run simulation
   g = simulation.randomGraph(50,0.4,1,10);
-  simulation.run(g);
+  simulation.run(g, chFile);
   
   return 0;  
 }
\ No newline at end of file
@@ -12,6 +12,31 @@
 #include <iomanip>
 #include <queue>
 #include <algorithm> // std::find
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <cstdlib> // posix_memalign
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <cassert>
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h> // open
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define HAVE_MMAP
+#endif
+#ifdef _MSC_VER
+  #include <malloc.h> // _aligned_malloc
+#endif
+#ifdef __AVX2__
+  #include <immintrin.h>
+#endif
 
 using namespace std::chrono;
 using namespace std;
@@ -19,12 +44,67 @@ using namespace std;
 // define limits for "length" or weight of the edges
 enum EdgeWeight { NO_CON = 0 };
 
-enum class Color { NO_COLOR, RED, GREEN, BLUE };
+enum class Color : uint8_t { NO_COLOR, RED, GREEN, BLUE };
+
+// weight type of the graph used in main(), any of uint8_t, uint16_t, int or double
+// small types allow much larger graphs in the same amount of RAM / cache
+typedef int Weight_t;
 
 // store weight / node
-typedef std::pair<int, int> Node_t;
+template <typename W>
+using Node_t = std::pair<W, int>;
 // typedef std::vector<Node_t> VNode_t;
 
+// #############################################################################
+// distance type used when summing up weights of type W
+// small integer weights are summed up in 32 bit, all integer sums saturate at
+// Infinity() instead of wrapping around
+// #############################################################################
+template <typename W>
+struct WeightTraits {
+  typedef W Dist_t;
+};
+
+template <>
+struct WeightTraits<uint8_t> {
+  typedef uint32_t Dist_t;
+};
+
+template <>
+struct WeightTraits<uint16_t> {
+  typedef uint32_t Dist_t;
+};
+
+// "no path" value of a distance type
+template <typename D>
+D Infinity() {
+  return numeric_limits<D>::has_infinity ? numeric_limits<D>::infinity()
+                                         : numeric_limits<D>::max();
+}
+
+// d + w, clamped to Infinity() for integer types (weights are non-negative)
+template <typename D, typename W>
+D Saturating_Add(D d, W w) {
+  if (!numeric_limits<D>::has_infinity && (d > Infinity<D>() - static_cast<D>(w))) {
+    return Infinity<D>();
+  }
+  return d + static_cast<D>(w);
+}
+
+// convert a weight read from file / generated to W, clamped to its range
+template <typename W>
+W Weight_Cast(int64_t w) {
+  if (numeric_limits<W>::is_integer) {
+    if (w < static_cast<int64_t>(numeric_limits<W>::lowest())) {
+      return numeric_limits<W>::lowest();
+    }
+    if (w > static_cast<int64_t>(numeric_limits<W>::max())) {
+      return numeric_limits<W>::max();
+    }
+  }
+  return static_cast<W>(w);
+}
+
 // overload << for printing out the color
 ostream& operator<<(ostream& os, Color c) {
   switch (c) {
@@ -44,473 +124,5658 @@ ostream& operator<<(ostream& os, Color c) {
   return os;
 }
 
+// set of colors, bit c is set if Color c is part of the set
+typedef uint8_t ColorMask;
+const ColorMask ALL_COLORS = 0xf;
+
+inline ColorMask Color_Bit(Color c) {
+  return 1 << static_cast<int>(c);
+}
+
+// parse a color set written as letters like operator<< prints them, e.g. "RG"
+// returns 0 if there is an unknown letter
+ColorMask Parse_Color_Mask(const string& text) {
+  ColorMask mask = 0;
+  for (char c : text) {
+    switch (toupper(c)) {
+    case 'R':
+      mask |= Color_Bit(Color::RED);
+      break;
+    case 'G':
+      mask |= Color_Bit(Color::GREEN);
+      break;
+    case 'B':
+      mask |= Color_Bit(Color::BLUE);
+      break;
+    default:
+      return 0;
+    }
+  }
+  return mask;
+}
+
 // #############################################################################
-// graph Class using Edge Matrix Representation
+// Bit packed square matrix, every row is a sequence of 64 bit words
+// row length is padded to a multiple of 4 words (256 bit) so that the AVX2
+// loop never needs a tail, padding bits are always zero
 // #############################################################################
-class GraphMatrix {
+class BitMatrix {
 public:
-  GraphMatrix(int32_t nNodes, float prob, vector<int> range);
+  BitMatrix() : n(0), rowWords(0) {};
+  BitMatrix(int nNodes) {
+    Resize(nNodes);
+  };
 
-  GraphMatrix(string fileName) {
-    Read_Graph_File(fileName);
+  ~BitMatrix() {};
+
+  // reset to an empty n x n matrix
+  void Resize(int nNodes) {
+    n        = nNodes;
+    rowWords = ((n + 255) / 256) * 4;
+    bits.assign(static_cast<size_t>(n) * rowWords, 0);
+  }
+
+  bool Get(int x, int y) const {
+    return (Row(x)[y >> 6] >> (y & 63)) & 1;
+  }
+
+  void Set(int x, int y) {
+    bits[static_cast<size_t>(x) * rowWords + (y >> 6)] |= (uint64_t(1) << (y & 63));
+  }
+
+  void Clear(int x, int y) {
+    bits[static_cast<size_t>(x) * rowWords + (y >> 6)] &= ~(uint64_t(1) << (y & 63));
+  }
+
+  const uint64_t* Row(int x) const {
+    return &bits[static_cast<size_t>(x) * rowWords];
+  }
+
+  int Row_Words() const {
+    return rowWords;
+  }
+
+  // number of set bits in row x (== out degree of node x)
+  int Count_Row(int x) const {
+    return Popcount(Row(x), rowWords);
+  }
+
+  // number of set bits in the whole matrix
+  int64_t Count() const {
+    return bits.empty() ? 0 : Popcount(bits.data(), bits.size());
+  }
+
+  // call f(y) for every set bit y of row x, in increasing order
+  template <class Fct>
+  void For_Each_In_Row(int x, Fct f) const {
+    const uint64_t* row = Row(x);
+    for (int w = 0; w < rowWords; w++) {
+      uint64_t word = row[w];
+      while (word) {
+        f((w << 6) + Count_Trailing_Zeros(word));
+        word &= word - 1; // clear lowest set bit
+      }
+    }
+  }
+
+  static int Count_Trailing_Zeros(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, word);
+    return idx;
+#else
+    return __builtin_ctzll(word);
+#endif
+  }
+
+  // hardware popcount over a block of words, nWords must be a multiple of 4
+  static int64_t Popcount(const uint64_t* words, size_t nWords);
+
+private:
+  int n;                 // number of rows / columns
+  int rowWords;          // 64 bit words per row (incl. padding)
+  vector<uint64_t> bits; // row major bit storage
+};
+
+// -----------------------------------------------------------------------------
+int64_t BitMatrix::Popcount(const uint64_t* words, size_t nWords) {
+  int64_t count = 0;
+#ifdef __AVX2__
+  // nibble lookup popcount, see http://0x80.pl/articles/sse-popcount.html
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                          3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                          2, 3, 2, 3, 3, 4);
+  const __m256i lowMask = _mm256_set1_epi8(0x0f);
+  __m256i acc           = _mm256_setzero_si256();
+  for (size_t i = 0; i < nWords; i += 4) {
+    __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    __m256i lo  = _mm256_and_si256(v, lowMask);
+    __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+    __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                  _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+  }
+  count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+          _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+#else
+  for (size_t i = 0; i < nWords; i++) {
+  #if defined(_MSC_VER)
+    count += __popcnt64(words[i]);
+  #else
+    count += __builtin_popcountll(words[i]); // popcnt instr. with -mpopcnt
+  #endif
+  }
+#endif
+  return count;
+}
+
+// #############################################################################
+// std::vector allocator returning cache line (64 byte) aligned memory
+// #############################################################################
+template <typename T, size_t ALIGN = 64>
+struct AlignedAllocator {
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, ALIGN> other;
   };
 
-  ~GraphMatrix() {};
+  AlignedAllocator() {};
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, ALIGN>&) {};
 
-  // methods defined below -----------------------------------------------------
-  void Print(void);       // print out connectivity matrix
-  void Print_Color(void); // print out color of nodes matrix
+  T* allocate(size_t count) {
+    void* ptr = nullptr;
+#ifdef _MSC_VER
+    ptr = _aligned_malloc(count * sizeof(T), ALIGN);
+#else
+    if (posix_memalign(&ptr, ALIGN, count * sizeof(T)) != 0) {
+      ptr = nullptr;
+    }
+#endif
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+  }
 
-  // return nodes y such that there is an edge from x to y.
-  vector<int> Get_Neighbors(int x);
-  // print neighbors for x
-  void Print_Neighbors(int x);
+  void deallocate(T* ptr, size_t) {
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+  }
+};
+
+template <typename T, typename U, size_t ALIGN>
+bool operator==(const AlignedAllocator<T, ALIGN>&, const AlignedAllocator<U, ALIGN>&) {
+  return true;
+}
 
-  void Read_Graph_File(string fileName);
+template <typename T, typename U, size_t ALIGN>
+bool operator!=(const AlignedAllocator<T, ALIGN>&, const AlignedAllocator<U, ALIGN>&) {
+  return false;
+}
 
-  void Prims_MST(int sourceNode);
+// memory layout of a square matrix
+// ROW_MAJOR: rows are contiguous and start on a cache line -> fast row scans
+// TILED: 64x64 blocks are contiguous -> rows and columns of a block are both
+//        cache friendly, good for algorithms sweeping in both directions that
+//        can't be blocked; --bench has a blocked sweep over ROW_MAJOR ahead
+enum class Layout { ROW_MAJOR, TILED };
 
-  // short inline methods  ---------------------------------------------------
-  // tests whether there is an edge from node x to node y.
-  bool Is_Adjacent(int x, int y) {
-    if ((x < n) && (y < n) && (x != y)) {
-      return conMap[x][y];
+// #############################################################################
+// square n x n matrix in a single aligned allocation
+// #############################################################################
+template <typename T>
+class AlignedMatrix {
+public:
+  static const int TILE_SHIFT = 6;               // log2 of the tile edge
+  static const int TILE       = 1 << TILE_SHIFT; // tile edge for Layout::TILED
+
+  AlignedMatrix() : n(0), stride(0), layout(Layout::ROW_MAJOR) {};
+  AlignedMatrix(int nNodes, T init, Layout l = Layout::ROW_MAJOR) {
+    Resize(nNodes, init, l);
+  };
+
+  ~AlignedMatrix() {};
+
+  // reset to an n x n matrix filled with init
+  void Resize(int nNodes, T init, Layout l = Layout::ROW_MAJOR) {
+    n      = nNodes;
+    layout = l;
+    if (layout == Layout::ROW_MAJOR) {
+      // pad each row to a whole number of cache lines
+      const int perLine = (64 % sizeof(T) == 0) ? 64 / sizeof(T) : 1;
+      stride            = ((n + perLine - 1) / perLine) * perLine;
+      data.assign(static_cast<size_t>(n) * stride, init);
     } else {
+      stride = (n + TILE - 1) / TILE; // number of tiles per row
+      data.assign(static_cast<size_t>(stride) * stride * TILE * TILE, init);
+    }
+  }
+
+  int Size() const {
+    return n;
+  }
+
+  Layout Get_Layout() const {
+    return layout;
+  }
+
+  // position of element (x, y) in the storage
+  size_t Index(int x, int y) const {
+    if (layout == Layout::ROW_MAJOR) {
+      return static_cast<size_t>(x) * stride + y;
+    }
+    const unsigned ux = x, uy = y;
+    size_t tile = static_cast<size_t>(ux >> TILE_SHIFT) * stride + (uy >> TILE_SHIFT);
+    return (tile << (2 * TILE_SHIFT)) + ((ux & (TILE - 1)) << TILE_SHIFT) +
+           (uy & (TILE - 1));
+  }
+
+  T& operator()(int x, int y) {
+    return data[Index(x, y)];
+  }
+
+  const T& operator()(int x, int y) const {
+    return data[Index(x, y)];
+  }
+
+  // pointer to the n contiguous elements of row x, Layout::ROW_MAJOR only
+  T* Row(int x) {
+    return &data[static_cast<size_t>(x) * stride];
+  }
+
+  const T* Row(int x) const {
+    return &data[static_cast<size_t>(x) * stride];
+  }
+
+private:
+  int n;         // number of rows / columns
+  int stride;    // ROW_MAJOR: elements per row, TILED: tiles per row
+  Layout layout; // memory layout
+  vector<T, AlignedAllocator<T>> data;
+};
+
+// single undirected edge as read from file / created at random
+template <typename W>
+struct Edge_t {
+  int from;
+  int to;
+  W weight;
+  Color color;
+};
+
+// #############################################################################
+// disjoint sets (union-find) with path compression and union by rank
+// #############################################################################
+class DisjointSets {
+public:
+  DisjointSets(int nNodes) : parent(nNodes), rank(nNodes, 0) {
+    for (int x = 0; x < nNodes; x++) {
+      parent[x] = x;
+    }
+  };
+
+  // representative of the set of x, all nodes on the way are linked to it
+  int Find(int x) {
+    int root = x;
+    while (parent[root] != root) {
+      root = parent[root];
+    }
+    while (parent[x] != root) {
+      int next  = parent[x];
+      parent[x] = root;
+      x         = next;
+    }
+    return root;
+  }
+
+  // merge the sets of x and y, returns false if they already are the same set
+  bool Union(int x, int y) {
+    x = Find(x);
+    y = Find(y);
+    if (x == y) {
       return false;
     }
+    // the lower tree is attached to the higher one
+    if (rank[x] < rank[y]) {
+      swap(x, y);
+    }
+    parent[y] = x;
+    if (rank[x] == rank[y]) {
+      rank[x]++;
+    }
+    return true;
+  }
+
+private:
+  vector<int32_t> parent; // parent node in the set tree, roots point to itself
+  vector<uint8_t> rank;   // upper bound of the tree height, < 32
+};
+
+// #############################################################################
+// disjoint sets for many threads at once, lock-free: Find halves the path with
+// compare and swap, Union links the root with the higher index below the other
+// one. The root of a set is its lowest node, so it doesn't depend on timing.
+// #############################################################################
+class ConcurrentDisjointSets {
+public:
+  ConcurrentDisjointSets(int nNodes) : parent(new atomic<int32_t>[nNodes]) {
+    for (int x = 0; x < nNodes; x++) {
+      parent[x].store(x, memory_order_relaxed);
+    }
   };
 
-  // adds to G the edge from x to y
-  // returns true if the edge was added, false if not added or already exists
-  bool Add_Node(int x, int y) {
-    if ((x < n) && (y < n) && (x != y)) {
-      conMap[x][y] = true;
-      return true;
+  int Find(int x) {
+    while (true) {
+      int32_t p = parent[x].load(memory_order_relaxed);
+      if (p == x) {
+        return x;
+      }
+      int32_t gp = parent[p].load(memory_order_relaxed);
+      if (gp != p) {
+        // fails if someone else changed it already, which is fine as well
+        parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+      }
+      x = gp;
+    }
+  }
+
+  // merge the sets of x and y, returns false if they already are the same set
+  // if several threads merge the same two sets, exactly one of them gets true
+  bool Union(int x, int y) {
+    while (true) {
+      x = Find(x);
+      y = Find(y);
+      if (x == y) {
+        return false;
+      }
+      if (x < y) {
+        swap(x, y);
+      }
+      // x might not be a root any more, then try again
+      int32_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y, memory_order_acq_rel)) {
+        return true;
+      }
+    }
+  }
+
+private:
+  unique_ptr<atomic<int32_t>[]> parent; // parent node, roots point to itself
+};
+
+// #############################################################################
+// indexed d-ary min-heap with one slot per node 0..n-1, keys can be decreased
+// in O(log n), so the heap never holds more than n entries
+// #############################################################################
+template <typename K, int ARITY = 4>
+class IndexedHeap {
+public:
+  IndexedHeap(int nNodes) : pos(nNodes, -1) {
+    keys.reserve(nNodes);
+    nodes.reserve(nNodes);
+  };
+
+  bool Empty() const {
+    return nodes.empty();
+  }
+
+  int Size() const {
+    return nodes.size();
+  }
+
+  // true if node is in the heap
+  bool Contains(int node) const {
+    return pos[node] >= 0;
+  }
+
+  // key of a node in the heap
+  const K& Get_Key(int node) const {
+    return keys[pos[node]];
+  }
+
+  // node with the smallest key
+  int Top() const {
+    return nodes[0];
+  }
+
+  // insert node, or lower its key if it is already in the heap
+  // returns false if the node is in the heap with a key that is not larger
+  bool Push(int node, const K& key) {
+    int i = pos[node];
+    if (i < 0) {
+      i = nodes.size();
+      keys.push_back(key);
+      nodes.push_back(node);
+      pos[node] = i;
+    } else if (key < keys[i]) {
+      keys[i] = key;
     } else {
       return false;
     }
+    Sift_Up(i);
+    return true;
   }
 
-  // removes the edge from x to y, if it is there.
-  void Del_Node(int x, int y) {
-    if ((x < n) && (y < n)) {
-      conMap[x][y] = false;
+  // remove and return the node with the smallest key
+  int Pop() {
+    int top  = nodes[0];
+    pos[top] = -1;
+    int last = nodes.size() - 1;
+    if (last > 0) {
+      keys[0]       = keys[last];
+      nodes[0]      = nodes[last];
+      pos[nodes[0]] = 0;
     }
-    return;
+    keys.pop_back();
+    nodes.pop_back();
+    if (last > 0) {
+      Sift_Down(0);
+    }
+    return top;
   }
 
-  // get weight of a connection between x and y
-  int Get_Weight(int x, int y) {
-    if ((x < n) && (y < n)) {
-      return weightMap[x][y];
-    } else {
-      return EdgeWeight::NO_CON;
+private:
+  // move the entry at i up, the hole is filled once at the end
+  void Sift_Up(int i) {
+    K key    = keys[i];
+    int node = nodes[i];
+    while (i > 0) {
+      int parent = (i - 1) / ARITY;
+      if (!(key < keys[parent])) {
+        break;
+      }
+      keys[i]       = keys[parent];
+      nodes[i]      = nodes[parent];
+      pos[nodes[i]] = i;
+      i             = parent;
     }
+    keys[i]   = key;
+    nodes[i]  = node;
+    pos[node] = i;
   }
 
-  // get number of graph nodes
-  int Get_Num_Nodes() {
-    return n;
+  // move the entry at i down to its smallest child as long as that is smaller
+  void Sift_Down(int i) {
+    K key    = keys[i];
+    int node = nodes[i];
+    int n    = nodes.size();
+    while (true) {
+      int first = i * ARITY + 1;
+      if (first >= n) {
+        break;
+      }
+      int best = first;
+      for (int c = first + 1; c < min(first + ARITY, n); c++) {
+        if (keys[c] < keys[best]) {
+          best = c;
+        }
+      }
+      if (!(keys[best] < key)) {
+        break;
+      }
+      keys[i]       = keys[best];
+      nodes[i]      = nodes[best];
+      pos[nodes[i]] = i;
+      i             = best;
+    }
+    keys[i]   = key;
+    nodes[i]  = node;
+    pos[node] = i;
   }
-  // same as Get_Num_Nodes() but close in style to stl vector size() etc
-  int Size() {
-    return n;
+
+  vector<K> keys;        // heap ordered keys
+  vector<int32_t> nodes; // node per heap slot
+  vector<int32_t> pos;   // heap slot per node, -1 if not in the heap
+};
+
+// #############################################################################
+// Dial's bucket queue for integer keys: a circle of maxWeight + 1 buckets, the
+// key k lives in bucket k % (maxWeight + 1). Same interface as IndexedHeap,
+// but the keys have to be monotone: every key pushed is in [last popped key,
+// last popped key + maxWeight], as in Dijkstra with weights 0..maxWeight.
+// Push is O(1), decrease-key pushes the node again and leaves the old entry
+// behind, it is dropped when its bucket comes up. Pop skips empty buckets.
+// #############################################################################
+template <typename K>
+class DialQueue {
+public:
+  DialQueue(int nNodes, int64_t maxWeight)
+      : keys(nNodes), inQueue(nNodes, 0), buckets(maxWeight + 1), nLive(0), slot(0),
+        current(0), base(0) {};
+
+  bool Empty() const {
+    return nLive == 0;
   }
 
-  // find number of edges in graph
-  int Get_Num_Edges();
+  int Size() const {
+    return nLive;
+  }
 
-  // calculate the graph density
-  float Get_Density();
+  // true if node is in the queue
+  bool Contains(int node) const {
+    return inQueue[node];
+  }
+
+  // key of a node in the queue
+  const K& Get_Key(int node) const {
+    return keys[node];
+  }
+
+  // insert node, or lower its key if it is already in the queue
+  // returns false if the node is in the queue with a key that is not larger.
+  // Precondition: the key is in [last popped key, last popped key + maxWeight]
+  // (an empty queue takes any key as the start), else two live keys could
+  // share a bucket and Pop would lose one of them. Within this window the
+  // keys may come in any order.
+  bool Push(int node, const K& key) {
+    const uint64_t k = static_cast<uint64_t>(key);
+    if (inQueue[node]) {
+      if (!(key < keys[node])) {
+        return false;
+      }
+    } else {
+      if ((nLive == 0) && ((k < base) || (k - base > buckets.size() - 1))) {
+        base = k;
+      }
+      inQueue[node] = 1;
+      nLive++;
+    }
+    assert((k >= base) && (k - base <= buckets.size() - 1));
+    // the smallest key starts the circle
+    if ((nLive == 1) || (k < current)) {
+      current = k;
+      slot    = current % buckets.size();
+    }
+    keys[node] = key;
+    buckets[static_cast<uint64_t>(key) % buckets.size()].push_back(node);
+    return true;
+  }
+
+  // remove and return a node with the smallest key
+  int Pop() {
+    while (true) {
+      while (buckets[slot].empty()) {
+        slot = (slot + 1 == static_cast<int>(buckets.size())) ? 0 : slot + 1;
+        current++;
+      }
+      int node = buckets[slot].back();
+      buckets[slot].pop_back();
+      // entries left behind by a decrease-key have a larger key
+      if (inQueue[node] && (static_cast<uint64_t>(keys[node]) == current)) {
+        inQueue[node] = 0;
+        nLive--;
+        base = current;
+        return node;
+      }
+    }
+  }
 
 private:
-  int n;                          // number of graph nodes / vertices
-  int nEdges;                     // number of edges
-  float density;                  // density of the graph
-  vector<vector<bool>> conMap;    // connectivity matrix
-  vector<vector<int>> weightMap;  // weight matrix, range 0-255
-  vector<vector<Color>> colorMap; // colors per node, range 0-3
-  vector<vector<Node_t>> nodes;   // matrix of nodes wight / node
+  vector<K> keys;                   // key per node
+  vector<uint8_t> inQueue;          // node is in the queue
+  vector<vector<int32_t>> buckets;  // nodes per key % number of buckets
+  int nLive;                        // number of nodes in the queue
+  int slot;                         // bucket of the smallest key
+  uint64_t current;                 // smallest key
+  uint64_t base;                    // last popped key, lower end of the keys
 };
 
-// fct declarations
-int minDistance(vector<int> dist, vector<bool> sptSet);
-void printSolution(vector<int> dist);
-void dijkstra(GraphMatrix G, int src);
-void swap(int& x, int& y);
+// #############################################################################
+// radix heap for non-negative integer keys: bucket b > 0 holds the keys whose
+// highest bit different from the last popped key is bit b - 1, bucket 0 the
+// keys equal to it. Same interface and the same monotone keys as DialQueue,
+// but the size doesn't depend on the largest weight. Every entry moves to a
+// lower bucket at most 64 times, decrease-key leaves the old entry behind and
+// it is dropped when it is seen again.
+// #############################################################################
+template <typename K>
+class RadixHeap {
+public:
+  RadixHeap(int nNodes) : keys(nNodes), inHeap(nNodes, 0), nLive(0), last(0) {};
 
-// -----------------------------------------------------------------------------
-// -----------------------------------------------------------------------------
-int main() {
+  bool Empty() const {
+    return nLive == 0;
+  }
 
-  auto startTime = high_resolution_clock::now();
+  int Size() const {
+    return nLive;
+  }
 
-  // GraphMatrix MyGraph(10, 0.20, {1, 9});
-  GraphMatrix MyGraph("../testdata_mst_data.txt");
+  // true if node is in the heap
+  bool Contains(int node) const {
+    return inHeap[node];
+  }
 
-  cout << endl;
-  cout << "########## Graph Infos ##########" << endl;
-  cout << "Number of nodes: " << (int)MyGraph.Size() << endl;
-  cout << "Number of edges: " << (int)MyGraph.Get_Num_Edges() << endl;
-  cout << "Density: " << MyGraph.Get_Density() << endl;
-  cout << endl;
+  // key of a node in the heap
+  const K& Get_Key(int node) const {
+    return keys[node];
+  }
 
-  MyGraph.Print();
+  // insert node, or lower its key if it is already in the heap
+  // returns false if the node is in the heap with a key that is not larger
+  bool Push(int node, const K& key) {
+    if (inHeap[node]) {
+      if (!(key < keys[node])) {
+        return false;
+      }
+    } else {
+      inHeap[node] = 1;
+      nLive++;
+    }
+    keys[node]  = key;
+    Entry entry = {static_cast<uint64_t>(key), node};
+    buckets[Bucket(entry.key)].push_back(entry);
+    return true;
+  }
 
-  cout << endl;
+  // remove and return a node with the smallest key
+  int Pop() {
+    while (true) {
+      if (buckets[0].empty()) {
+        Refill();
+      }
+      Entry entry = buckets[0].back();
+      buckets[0].pop_back();
+      if (Is_Live(entry)) {
+        inHeap[entry.node] = 0;
+        nLive--;
+        return entry.node;
+      }
+    }
+  }
 
-  MyGraph.Prims_MST(0);
+private:
+  struct Entry {
+    uint64_t key;
+    int32_t node;
+  };
 
-  auto stopTime            = high_resolution_clock::now();
-  duration<float> duration = stopTime - startTime;
+  // false for entries left behind by a decrease-key or a pop
+  bool Is_Live(const Entry& entry) const {
+    return inHeap[entry.node] &&
+           (static_cast<uint64_t>(keys[entry.node]) == entry.key);
+  }
+
+  int Bucket(uint64_t key) const {
+    uint64_t diff = key ^ last;
+    if (diff == 0) {
+      return 0;
+    }
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, diff);
+    return idx + 1;
+#else
+    return 64 - __builtin_clzll(diff);
+#endif
+  }
+
+  // move the smallest key into bucket 0: the first non-empty bucket holds it,
+  // relative to it all entries of that bucket go to lower buckets
+  void Refill() {
+    for (int b = 1; b < 65; b++) {
+      vector<Entry>& bucket = buckets[b];
+      size_t nKept          = 0;
+      uint64_t minKey       = numeric_limits<uint64_t>::max();
+      for (const Entry& entry : bucket) {
+        if (Is_Live(entry)) {
+          bucket[nKept++] = entry;
+          minKey          = min(minKey, entry.key);
+        }
+      }
+      bucket.resize(nKept);
+      if (nKept == 0) {
+        continue;
+      }
+      last = minKey;
+      for (const Entry& entry : bucket) {
+        buckets[Bucket(entry.key)].push_back(entry);
+      }
+      bucket.clear();
+      return;
+    }
+  }
+
+  vector<K> keys;            // key per node
+  vector<uint8_t> inHeap;    // node is in the heap
+  int nLive;                 // number of nodes in the heap
+  uint64_t last;             // last popped key
+  vector<Entry> buckets[65]; // entries by highest bit different from last
+};
+
+// #############################################################################
+// read only view of a whole file, memory mapped where the OS supports it,
+// otherwise the file is read into a buffer
+// #############################################################################
+class MappedFile {
+public:
+  MappedFile() : base(nullptr), size(0) {};
+  ~MappedFile() {
+    Close();
+  };
+
+  // no copies, the mapping is shared through shared_ptr<MappedFile>
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(string fileName);
+  void Close();
+
+  const char* Data() const {
+    return base;
+  }
+
+  size_t Size() const {
+    return size;
+  }
+
+private:
+  const char* base;        // first byte of the file
+  size_t size;             // file size in bytes
+  vector<uint64_t> buffer; // file content if mmap is not available
+};
+
+// -----------------------------------------------------------------------------
+bool MappedFile::Open(string fileName) {
+  Close();
+#ifdef HAVE_MMAP
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  if ((fstat(fd, &info) != 0) || (info.st_size == 0)) {
+    close(fd);
+    return false;
+  }
+  void* ptr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping stays valid after closing the file
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+  base = static_cast<const char*>(ptr);
+  size = info.st_size;
+#else
+  ifstream file(fileName, ios::binary | ios::ate);
+  if (!file.is_open()) {
+    return false;
+  }
+  size = file.tellg();
+  buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(buffer.data()), size);
+  base = reinterpret_cast<const char*>(buffer.data());
+#endif
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+void MappedFile::Close() {
+#ifdef HAVE_MMAP
+  if (base != nullptr) {
+    munmap(const_cast<char*>(base), size);
+  }
+#endif
+  buffer.clear();
+  base = nullptr;
+  size = 0;
+}
+
+// #############################################################################
+// streaming reader for text graph files, reads through a fixed size buffer so
+// memory use does not depend on the file size, fileName "-" reads from stdin
+// #############################################################################
+class EdgeReader {
+public:
+  EdgeReader(size_t bufferSize = 1 << 16)
+      : file(nullptr), buffer(bufferSize), pos(0), len(0), eof(true), line(0),
+        nNodes(0), nErrors(0) {};
+  ~EdgeReader() {
+    Close();
+  };
+
+  EdgeReader(const EdgeReader&)            = delete;
+  EdgeReader& operator=(const EdgeReader&) = delete;
+
+  // open the file and read the number of nodes from the first line
+  bool Open(string fileName);
+  void Close();
+
+  // read the next edge, bad lines are reported and skipped
+  // returns false at the end of the file, the color of the edge is not set
+  template <typename W>
+  bool Next(Edge_t<W>& edge);
+
+  int Get_Num_Nodes() const {
+    return nNodes;
+  }
+
+  int64_t Get_Num_Errors() const {
+    return nErrors;
+  }
+
+private:
+  bool Next_Line(const char*& begin, const char*& end);
+  void Report(const string& message);
+
+  string fileName;
+  FILE* file;          // nullptr if closed
+  vector<char> buffer; // fixed size, a line has to fit in
+  size_t pos;          // start of the unread data in buffer
+  size_t len;          // end of the valid data in buffer
+  bool eof;            // no more data in file
+  int64_t line;        // number of the last line returned, starting at 1
+  int nNodes;          // from the first line of the file
+  int64_t nErrors;     // number of bad lines
+};
+
+// #############################################################################
+// buffered writer for results, fileName "-" writes to stdout. Numbers are
+// formatted by hand into a fixed size buffer, which only goes to the file
+// when it is full or on Close, no flush per line like endl does
+// #############################################################################
+class ResultWriter {
+public:
+  ResultWriter(size_t bufferSize = 1 << 16)
+      : file(nullptr), buffer(bufferSize), len(0), ok(false) {};
+  ~ResultWriter() {
+    Close();
+  };
+
+  ResultWriter(const ResultWriter&)            = delete;
+  ResultWriter& operator=(const ResultWriter&) = delete;
+
+  bool Open(string fileName);
+  // write out the rest of the buffer, returns false if a write failed
+  bool Close();
+
+  void Put(char c) {
+    if (len == buffer.size()) {
+      Flush();
+    }
+    buffer[len++] = c;
+  }
+
+  void Put(const char* text) {
+    Put_Bytes(text, strlen(text));
+  }
+
+  // decimal, zero padded to at least minDigits digits like setfill('0') and
+  // setw(minDigits) for non-negative values
+  void Put_Int(int64_t value, int minDigits = 1);
+  // same as cout << value with the default precision of 6 digits
+  void Put_Double(double value, int precision = 6);
+  void Put_Bytes(const void* data, size_t bytes);
+
+  // weights and distances, integers as Put_Int, the rest as Put_Double
+  template <typename T>
+  void Put_Number(T value) {
+    if (numeric_limits<T>::is_integer) {
+      Put_Int(static_cast<int64_t>(value));
+    } else {
+      Put_Double(static_cast<double>(value));
+    }
+  }
+
+  // same with all digits needed to read the value back unchanged (csv)
+  template <typename T>
+  void Put_Number_Exact(T value) {
+    if (numeric_limits<T>::is_integer) {
+      Put_Int(static_cast<int64_t>(value));
+    } else {
+      Put_Double(static_cast<double>(value), numeric_limits<T>::max_digits10);
+    }
+  }
+
+private:
+  void Flush();
+
+  FILE* file;          // nullptr if closed
+  vector<char> buffer; // fixed size
+  size_t len;          // bytes used in buffer
+  bool ok;             // false after a failed write
+};
+
+// #############################################################################
+// results of the graph algorithms, to be used by code or written out by
+// Write_MST / Write_SSSP
+// #############################################################################
+// minimum spanning tree / forest
+template <typename W>
+struct MST_Result {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  vector<Edge_t<W>> edges; // lower node first, sorted by nodes
+  vector<int32_t> parent;  // parent node in the tree, -1 for the roots
+  Dist_t cost;             // sum of the weights, saturates
+  int nTreeNodes;          // number of nodes with at least one tree edge
+};
+
+// single source shortest paths
+template <typename W>
+struct SSSP_Result {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  int source;
+  vector<Dist_t> dist;    // Infinity<Dist_t>() if not reachable
+  vector<int32_t> parent; // predecessor on a shortest path, -1 for the
+                          // source and nodes that are not reachable
+  int nReached;           // number of nodes with a finite distance, with source
+};
+
+// all pairs shortest paths, statistics over the pairs u != v with a path
+template <typename W>
+struct APSP_Result {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  AlignedMatrix<Dist_t> dist; // dist(u, v), Infinity<Dist_t>() if not reachable
+  int64_t nPairs;             // number of ordered pairs u != v with a path
+  double sum;                 // sum of their distances
+  double average;             // sum / nPairs, 0 if there is no such pair
+  Dist_t diameter;            // longest of the shortest paths
+};
+
+// shortest path between two nodes
+template <typename W>
+struct Path_Result {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  vector<int32_t> path; // source ... target, empty if not reachable
+  Dist_t cost;          // Infinity<Dist_t>() if not reachable
+  int nSettled;         // number of nodes taken from the queue
+};
+
+// how Write_MST / Write_SSSP write a result
+// TEXT:   as printed by the homework, CSV: one line per edge / node
+// BINARY: ResultFileHeader followed by the arrays
+enum class ResultFormat { TEXT, CSV, BINARY };
+
+// #############################################################################
+// allocation free view on the neighbors of a node, yields Neighbor_t by value
+// for (auto nb : g.Neighbors(x)) { nb.node, nb.weight, nb.color }
+// #############################################################################
+template <typename W>
+struct Neighbor_t {
+  int node;
+  W weight;
+  Color color;
+};
+
+template <typename W>
+class NeighborRange {
+public:
+  class Iterator {
+  public:
+    Iterator(const int32_t* t, const W* w, const Color* c)
+        : target(t), weight(w), color(c) {};
+
+    Neighbor_t<W> operator*() const {
+      Neighbor_t<W> nb = {*target, *weight, *color};
+      return nb;
+    }
+
+    Iterator& operator++() {
+      target++;
+      weight++;
+      color++;
+      return *this;
+    }
+
+    bool operator!=(const Iterator& other) const {
+      return target != other.target;
+    }
+
+  private:
+    const int32_t* target;
+    const W* weight;
+    const Color* color;
+  };
+
+  NeighborRange(const int32_t* t, const W* w, const Color* c, int count)
+      : targets(t), weights(w), colors(c), n(count) {};
+
+  Iterator begin() const {
+    return Iterator(targets, weights, colors);
+  }
+
+  Iterator end() const {
+    return Iterator(targets + n, weights + n, colors + n);
+  }
+
+  int Size() const {
+    return n;
+  }
+
+private:
+  const int32_t* targets;
+  const W* weights;
+  const Color* colors;
+  int n;
+};
+
+// #############################################################################
+// binary graph file, version 1
+// header, followed by the CSR arrays, every array starts on a 64 byte boundary
+//   int32_t offsets[nNodes + 1]
+//   int32_t targets[nEdges]
+//   W       weights[nEdges]
+//   uint8_t colors[nEdges]
+// all values are stored in the byte order of the machine that wrote the file
+// #############################################################################
+const char GRAPH_FILE_MAGIC[8]    = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint32_t GRAPH_BYTE_ORDER   = 0x01020304;
+
+struct GraphFileHeader {
+  char magic[8];        // GRAPH_FILE_MAGIC
+  uint32_t version;     // GRAPH_FILE_VERSION
+  uint32_t byteOrder;   // GRAPH_BYTE_ORDER as written by the creator
+  uint32_t weightBytes; // sizeof(W)
+  uint32_t weightKind;  // 0: unsigned integer, 1: signed integer, 2: floating
+  int64_t nNodes;       // number of graph nodes
+  int64_t nEdges;       // number of stored (directed) edges
+  int64_t offsetsPos;   // byte position of the arrays in the file
+  int64_t targetsPos;
+  int64_t weightsPos;
+  int64_t colorsPos;
+  int64_t fileSize; // total file size in bytes
+};
+
+// weight kind stored in the file header
+template <typename W>
+uint32_t Weight_Kind() {
+  return numeric_limits<W>::is_integer ? (numeric_limits<W>::is_signed ? 1 : 0) : 2;
+}
+
+// round up to the next 64 byte boundary
+inline int64_t Align_64(int64_t pos) {
+  return (pos + 63) & ~int64_t(63);
+}
+
+// #############################################################################
+// binary result file, version 1
+// header, followed by the arrays without any padding
+//   MST:  int32_t parent[nNodes], int32_t from[nEdges], int32_t to[nEdges],
+//         W weight[nEdges], uint8_t color[nEdges]
+//   SSSP: Dist_t dist[nNodes], int32_t parent[nNodes]
+// all values are stored in the byte order of the machine that wrote the file
+// #############################################################################
+const char RESULT_FILE_MAGIC[8]    = {'G', 'R', 'E', 'S', 'U', 'L', 'T', ' '};
+const uint32_t RESULT_FILE_VERSION = 1;
+
+struct ResultFileHeader {
+  char magic[8];        // RESULT_FILE_MAGIC
+  uint32_t version;     // RESULT_FILE_VERSION
+  uint32_t byteOrder;   // GRAPH_BYTE_ORDER as written by the creator
+  uint32_t kind;        // 0: MST, 1: SSSP
+  uint32_t valueBytes;  // sizeof(W) for MST, sizeof(Dist_t) for SSSP
+  uint32_t valueKind;   // see Weight_Kind
+  int32_t source;       // SSSP source node, -1 for MST
+  int64_t nNodes;       // number of graph nodes
+  int64_t nEdges;       // number of MST edges, 0 for SSSP
+  int64_t nReached;     // MST: nodes in a tree, SSSP: reachable nodes
+  double cost;          // MST cost, SSSP sum of the finite distances
+};
+
+// #############################################################################
+// binary landmark file, version 1, the ALT tables of a graph file <graph> are
+// kept in <graph>.alt. Header, followed by the arrays without any padding
+//   int32_t landmarks[nLandmarks], Dist_t dist[nNodes * nLandmarks]
+// graphHash (see Graph_Hash) tells whether the graph changed since then
+// all values are stored in the byte order of the machine that wrote the file
+// #############################################################################
+const char LANDMARK_FILE_MAGIC[8]    = {'A', 'L', 'T', 'T', 'A', 'B', 'L', 'E'};
+const uint32_t LANDMARK_FILE_VERSION = 1;
+
+struct LandmarkFileHeader {
+  char magic[8];        // LANDMARK_FILE_MAGIC
+  uint32_t version;     // LANDMARK_FILE_VERSION
+  uint32_t byteOrder;   // GRAPH_BYTE_ORDER as written by the creator
+  uint32_t distBytes;   // sizeof(Dist_t)
+  uint32_t distKind;    // see Weight_Kind
+  int64_t nNodes;       // number of graph nodes
+  int64_t nEdges;       // number of stored (directed) edges
+  uint64_t graphHash;   // Graph_Hash of the graph
+  int64_t nLandmarks;   // number of landmarks
+};
+
+// #############################################################################
+// graph Class using Compressed Sparse Row (CSR) Representation
+// the neighbors of node x are stored at the index range
+// [offsets[x], offsets[x+1]) of the targets, weights and colors arrays
+// -> memory and traversal are O(n + m) instead of O(n^2)
+// the arrays are either owned by the object or point into a memory mapped
+// binary graph file (see Map_Binary_File), which is traversed without copying
+// #############################################################################
+template <typename W>
+class GraphCSR {
+public:
+  GraphCSR() : n(0), m(0) {
+    Bind();
+  };
+
+  // build from an undirected edge list, every edge is stored in both directions
+  // duplicate edges are merged, the last one in the list wins
+  GraphCSR(int nNodes, const vector<Edge_t<W>>& edges);
+
+  // build from a (directed) connectivity matrix
+  GraphCSR(const BitMatrix& conMap,
+           const AlignedMatrix<W>& weightMap,
+           const AlignedMatrix<Color>& colorMap);
+
+  // copies of a mapped graph share the mapping, owned arrays are copied
+  GraphCSR(const GraphCSR& other) {
+    *this = other;
+  };
+
+  GraphCSR(GraphCSR&& other) {
+    *this = std::move(other);
+  };
+
+  GraphCSR& operator=(GraphCSR&& other) {
+    n       = other.n;
+    m       = other.m;
+    offsets = std::move(other.offsets);
+    targets = std::move(other.targets);
+    weights = std::move(other.weights);
+    colors  = std::move(other.colors);
+    mapping = std::move(other.mapping);
+    Bind(&other);
+    return *this;
+  }
+
+  GraphCSR& operator=(const GraphCSR& other) {
+    n       = other.n;
+    m       = other.m;
+    offsets = other.offsets;
+    targets = other.targets;
+    weights = other.weights;
+    colors  = other.colors;
+    mapping = other.mapping;
+    Bind(&other);
+    return *this;
+  }
+
+  ~GraphCSR() {};
+
+  // write the graph as binary graph file
+  bool Write_Binary_File(string fileName) const;
+
+  // map a binary graph file, the header, offsets and targets are checked in
+  // one pass -> O(n + m), nothing is copied
+  bool Map_Binary_File(string fileName);
+
+  // short inline methods  ---------------------------------------------------
+  int Size() const {
+    return n;
+  }
+
+  // number of stored (directed) edges
+  int Get_Num_Edges() const {
+    return m;
+  }
+
+  // true if the arrays live in a memory mapped file
+  bool Is_Mapped() const {
+    return mapping != nullptr;
+  }
+
+  // first edge index of node x
+  int Begin(int x) const {
+    return pOffsets[x];
+  }
+
+  // one past the last edge index of node x
+  int End(int x) const {
+    return pOffsets[x + 1];
+  }
+
+  int Target(int e) const {
+    return pTargets[e];
+  }
+
+  W Weight(int e) const {
+    return pWeights[e];
+  }
+
+  Color Get_Color(int e) const {
+    return pColors[e];
+  }
+
+  // neighbors of node x with weight and color of the connecting edge
+  NeighborRange<W> Neighbors(int x) const {
+    int e = pOffsets[x];
+    return NeighborRange<W>(pTargets + e, pWeights + e, pColors + e, pOffsets[x + 1] - e);
+  }
+
+private:
+  // point the array pointers to the owned vectors, or for a mapped graph to
+  // the same place as the mapped graph "other" (moved vectors keep their data)
+  void Bind(const GraphCSR* other = nullptr) {
+    if (mapping && other) {
+      pOffsets = other->pOffsets;
+      pTargets = other->pTargets;
+      pWeights = other->pWeights;
+      pColors  = other->pColors;
+    } else {
+      pOffsets = offsets.data();
+      pTargets = targets.data();
+      pWeights = weights.data();
+      pColors  = colors.data();
+    }
+  }
+
+  int n;                                // number of graph nodes / vertices
+  int m;                                // number of stored (directed) edges
+  vector<int32_t> offsets;              // n + 1 entries, edge range per node
+  vector<int32_t> targets;              // neighbor node per edge
+  vector<W> weights;                    // weight per edge
+  vector<Color> colors;                 // color per edge
+  shared_ptr<const MappedFile> mapping; // set if the arrays are memory mapped
+  const int32_t* pOffsets;              // arrays used for traversal, point to
+  const int32_t* pTargets;              // the vectors above or into the
+  const W* pWeights;                    // mapped file
+  const Color* pColors;
+};
+
+// graphs with at least this density use the dense O(n^2) kernels for Prim
+// (and Dijkstra) instead of the CSR based ones; --bench-dense puts the
+// crossover of Prim at about 0.2 for 2000 and 6000 nodes, of Dijkstra at about
+// 0.4. Only the SIMD kernels win, the scalar ones are slower at every density.
+const float DENSE_MIN_DENSITY          = 0.2f;
+const float DENSE_DIJKSTRA_MIN_DENSITY = 0.4f;
+
+// weight types with a SIMD kernel for the dense Prim and Dijkstra
+template <typename W>
+struct Dense_Simd : false_type {};
+#ifdef __AVX2__
+template <>
+struct Dense_Simd<int32_t> : true_type {};
+template <>
+struct Dense_Simd<uint8_t> : true_type {};
+template <>
+struct Dense_Simd<uint16_t> : true_type {};
+#endif
+
+// queue used by Dijkstra_SSSP, AUTO picks by the edge weights
+enum class SSSPQueue { AUTO, HEAP, DIAL, RADIX };
+
+// integer weights up to this use Dial's bucket queue, larger ones the radix
+// heap; --bench-queues has Dial ahead for weights 1..9 and about even with the
+// radix heap for 1..99, the radix heap ahead from 1..999 on
+const int64_t DIAL_MAX_WEIGHT = 100;
+
+// integer weights up to this use the bucket Kruskal, one bucket per weight; it
+// beats the filter Kruskal for every weight range in --bench-queues
+const int64_t BUCKET_KRUSKAL_MAX_WEIGHT = 1 << 16;
+
+// #############################################################################
+// graph Class using Edge Matrix Representation
+// W is the weight type, see WeightTraits
+// The graph is held either as CSR or as n x n matrices, the other one is built
+// from it on first use. A graph read from file starts as CSR and only gets the
+// O(n^2) matrices if a method needs them (Print, the dense kernels, changes
+// of single edges), the CSR algorithms stay at O(n + m) memory.
+// #############################################################################
+template <typename W>
+class GraphMatrix {
+public:
+  GraphMatrix(int32_t nNodes, float prob, vector<int> range);
+
+  // empty graph, e.g. to call Read_Graph_File on
+  GraphMatrix() : n(0), density(0), matricesValid(true), csrValid(false) {
+    Reset_Stats();
+  };
+
+  // graph of a text file, empty if the file can't be read
+  GraphMatrix(string fileName) : GraphMatrix() {
+    Read_Graph_File(fileName);
+  };
+
+  ~GraphMatrix() {};
+
+  // methods defined below -----------------------------------------------------
+  void Print(void);       // print out connectivity matrix
+  void Print_Color(void); // print out color of nodes matrix
+
+  // return nodes y such that there is an edge from x to y.
+  vector<int> Get_Neighbors(int x);
+  // same without allocation, yields (node, weight, color), see NeighborRange
+  NeighborRange<W> Neighbors(int x) {
+    return Get_CSR().Neighbors(x);
+  }
+  // compact adjacency used by the graph algorithms, rebuilt if the
+  // connectivity matrix was changed since the last call
+  const GraphCSR<W>& Get_CSR() const;
+  // build the matrices from the CSR, if they are not there yet
+  void Build_Matrices() const;
+  // print neighbors for x
+  void Print_Neighbors(int x);
+
+  // returns false if the file can't be opened, the graph is empty then
+  bool Read_Graph_File(string fileName);
+
+  void Prims_MST(int sourceNode);
+  void Kruskal_MST(void);
+  // parallel minimum spanning forest, nThreads = 0 uses one thread per core
+  void Boruvka_MST(int nThreads = 0);
+  // minimum spanning forest using only the edges with a color in mask
+  void Prims_MST_Forest(ColorMask mask);
+
+  // short inline methods  ---------------------------------------------------
+  // tests whether there is an edge from node x to node y.
+  bool Is_Adjacent(int x, int y) {
+    if ((x < n) && (y < n) && (x != y)) {
+      Build_Matrices();
+      return conMap.Get(x, y);
+    } else {
+      return false;
+    }
+  };
+
+  // adds to G the edge from x to y
+  // returns true if the edge was added, false if not added or already exists
+  bool Add_Node(int x, int y) {
+    if ((x < n) && (y < n) && (x != y) && !Is_Adjacent(x, y)) {
+      conMap.Set(x, y);
+      Count_Edge(x, +1);
+      csrValid = false;
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // removes the edge from x to y, if it is there.
+  void Del_Node(int x, int y) {
+    if ((x < n) && (y < n) && (x != y) && Is_Adjacent(x, y)) {
+      conMap.Clear(x, y);
+      Count_Edge(x, -1);
+      csrValid = false;
+    }
+    return;
+  }
+
+  // get weight of a connection between x and y
+  W Get_Weight(int x, int y) {
+    if ((x < n) && (y < n)) {
+      Build_Matrices();
+      return weightMap(x, y);
+    } else {
+      return EdgeWeight::NO_CON;
+    }
+  }
+
+  // get number of graph nodes
+  int Get_Num_Nodes() {
+    return n;
+  }
+  // same as Get_Num_Nodes() but close in style to stl vector size() etc
+  int Size() {
+    return n;
+  }
+
+  // graph statistics, kept up to date on every change -> O(1) queries -------
+  // find number of edges in graph
+  int Get_Num_Edges() {
+    return nEdges;
+  }
+
+  // number of edges leaving node x
+  int Get_Degree(int x) {
+    if (x < n) {
+      return degree[x];
+    } else {
+      return 0;
+    }
+  }
+
+  // number of nodes per degree, index == degree
+  const vector<int>& Get_Degree_Histogram() {
+    return degreeHist;
+  }
+
+  // the matrices, used by the dense graph kernels
+  const BitMatrix& Get_Connections() const {
+    Build_Matrices();
+    return conMap;
+  }
+
+  const AlignedMatrix<W>& Get_Weights() const {
+    Build_Matrices();
+    return weightMap;
+  }
+
+  const AlignedMatrix<Color>& Get_Colors() const {
+    Build_Matrices();
+    return colorMap;
+  }
+
+  // true if the dense O(n^2) kernels are faster than the sparse ones, which
+  // needs a SIMD kernel for W and the crossover density of the algorithm
+  bool Is_Dense(float minDensity = DENSE_MIN_DENSITY) const {
+    return Dense_Simd<W>::value && (Get_Density() >= minDensity);
+  }
+
+  // calculate the graph density
+  float Get_Density() const {
+    // we don't allow self-loop
+    int64_t nPossibleEdges = static_cast<int64_t>(n) * (n - 1);
+    density = (nPossibleEdges > 0) ? static_cast<float>(nEdges) / nPossibleEdges : 0;
+    return density;
+  }
+
+private:
+  // clear the statistics of an empty graph with n nodes
+  void Reset_Stats() {
+    nEdges = 0;
+    degree.assign(n, 0);
+    degreeHist.assign(n + 1, 0);
+    degreeHist[0] = n;
+  }
+
+  // account for delta (+1/-1) edges leaving node x
+  void Count_Edge(int x, int delta) {
+    degreeHist[degree[x]]--;
+    degree[x] += delta;
+    degreeHist[degree[x]]++;
+    nEdges += delta;
+  }
+
+  int n;                          // number of graph nodes / vertices
+  int nEdges;                     // number of edges
+  mutable float density;          // density of the graph
+  vector<int> degree;             // number of edges per node
+  vector<int> degreeHist;         // number of nodes per degree
+  mutable BitMatrix conMap;           // connectivity matrix, bit packed
+  mutable AlignedMatrix<W> weightMap; // weight matrix, range of W
+  mutable AlignedMatrix<Color> colorMap; // colors per node, range 0-3
+  mutable bool matricesValid;         // false if the matrices are out of date
+  mutable GraphCSR<W> csr;            // compact adjacency for traversal
+  mutable bool csrValid;              // false if csr is out of date
+};
+
+// #############################################################################
+// minimum spanning forest kept up to date while edges are inserted, deleted or
+// change their weight, instead of running Prim again after every change.
+// The forest is held in a link-cut tree (Sleator, Tarjan) in which every tree
+// edge is a node of its own between its two end nodes, so the heaviest edge on
+// the tree path between two nodes is found in O(log n) amortized:
+//  - a new or cheaper non-tree edge replaces the heaviest edge on the cycle it
+//    closes, if it is lighter
+//  - a deleted or heavier tree edge is replaced by the cheapest edge between
+//    the two halves of its tree. Both halves are searched at the same time
+//    and only the edges of the smaller one are looked at.
+// Edges are ordered as MST_Less, so the forest is the one Kruskal finds.
+// #############################################################################
+template <typename W>
+class DynamicMST {
+public:
+  // exact sum of weights, integer sums don't saturate as they can go down again
+  typedef typename conditional<numeric_limits<W>::is_integer, int64_t, W>::type Cost_t;
+
+  DynamicMST(int nNodes);
+  // all edges of g, the first forest is built by Kruskal
+  DynamicMST(const GraphCSR<W>& g);
+
+  // returns false if x == y, a node is out of range or the edge already exists
+  bool Insert_Edge(int x, int y, W weight, Color color = Color::NO_COLOR);
+  // returns false if there is no edge between x and y
+  bool Delete_Edge(int x, int y);
+  bool Set_Weight(int x, int y, W weight);
+
+  // the edges of the forest / all edges, lower node first
+  vector<Edge_t<W>> Get_Tree() const;
+  vector<Edge_t<W>> Get_Edges() const;
+
+  // short inline methods  ---------------------------------------------------
+  // sum of the weights of the forest, O(1)
+  Cost_t Get_Cost() const {
+    return cost;
+  }
+
+  int Get_Num_Tree_Edges() const {
+    return nTreeEdges;
+  }
+
+  int Get_Num_Edges() const {
+    return static_cast<int>(edges.size() - freeEdges.size());
+  }
+
+  int Size() const {
+    return n;
+  }
+
+  bool Is_Tree_Edge(int x, int y) const {
+    int e = Find_Edge(x, y);
+    return (e >= 0) && edges[e].inTree;
+  }
+
+private:
+  struct Edge {
+    int32_t lo;     // lower node, -1 if the slot is free
+    int32_t hi;     // higher node
+    W weight;
+    Color color;
+    bool inTree;
+    int32_t pos[2]; // position in the adjacency of lo and hi
+  };
+
+  // entry of the adjacency of a node
+  struct Slot {
+    int32_t node; // neighbor
+    int32_t edge;
+  };
+
+  // node of the link-cut tree: 0..n-1 are the graph nodes, n + e is edge e
+  struct LctNode {
+    int32_t child[2]; // children in the splay tree, -1 if none
+    int32_t parent;   // parent in the splay tree or path parent, -1 if none
+    int32_t maxEdge;  // heaviest edge in the splay subtree, -1 if none
+    bool flip;        // children of the subtree still have to be swapped
+  };
+
+  // edge between x and y or -1, the shorter adjacency is searched
+  int Find_Edge(int x, int y) const {
+    if ((x < 0) || (y < 0) || (x >= n) || (y >= n)) {
+      return -1;
+    }
+    if (adjacency[y].size() < adjacency[x].size()) {
+      swap(x, y);
+    }
+    for (const Slot& slot : adjacency[x]) {
+      if (slot.node == y) {
+        return slot.edge;
+      }
+    }
+    return -1;
+  }
+
+  // order of MST_Less, -1 (no edge) is lighter than every edge
+  bool Lighter(int a, int b) const {
+    if ((a < 0) || (b < 0)) {
+      return b >= 0;
+    }
+    const Edge& ea = edges[a];
+    const Edge& eb = edges[b];
+    if (ea.weight != eb.weight) {
+      return ea.weight < eb.weight;
+    }
+    return (ea.lo != eb.lo) ? (ea.lo < eb.lo) : (ea.hi < eb.hi);
+  }
+
+  int New_Edge(int x, int y, W weight, Color color);
+  void Free_Edge(int e);
+  void Link_Edge(int e);
+  void Cut_Edge(int e);
+  void Try_Replace(int e);
+  int Find_Replacement(int u, int v);
+
+  // link-cut tree
+  bool Is_Splay_Root(int x) const {
+    int p = lct[x].parent;
+    return (p < 0) || ((lct[p].child[0] != x) && (lct[p].child[1] != x));
+  }
+  void Update(int x);
+  void Push(int x);
+  void Rotate(int x);
+  void Splay(int x);
+  void Access(int x);
+  void Make_Root(int x);
+  int Find_Root(int x);
+  void Link(int x, int y);
+  void Cut(int x, int y);
+  int Path_Max(int x, int y);
+
+  int n;                                    // number of graph nodes
+  int nTreeEdges;                           // number of forest edges
+  Cost_t cost;                              // weight of the forest
+  vector<Edge> edges;                       // edge slots
+  vector<int32_t> freeEdges;                // free edge slots
+  vector<vector<Slot>> adjacency;           // edges per node
+  vector<LctNode> lct;                      // n + edges.size() nodes
+  vector<int32_t> splayPath;                // scratch space of Splay
+  vector<int32_t> mark;                     // per node, see Find_Replacement
+  int32_t stamp;                            // marks of the current search
+  vector<int32_t> half[2];                  // scratch space of Find_Replacement
+};
+
+// #############################################################################
+// ALT (A*, landmarks, triangle inequality) for many shortest path queries on
+// the same undirected graph. The distances of k landmarks to all nodes are
+// computed once, then for all nodes v, t and every landmark l
+//   dist(v, t) >= |dist(l, t) - dist(l, v)|
+// The largest of these bounds is a consistent A* heuristic, so the search
+// heads for the target and settles far fewer nodes than Dijkstra.
+// Landmarks are picked one after the other as the node farthest from all the
+// landmarks so far (unreachable counts as farthest -> every component gets
+// one), the first one farthest from node 0. Weights must not be negative.
+// #############################################################################
+template <typename W>
+class LandmarkIndex {
+public:
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  LandmarkIndex() : n(0), k(0) {};
+
+  ~LandmarkIndex() {};
+
+  // pick nLandmarks landmarks of g and compute their distance tables
+  void Build(const GraphCSR<W>& g, int nLandmarks);
+
+  // binary landmark file of the tables, Read_File fails if the file is
+  // missing or was written for another graph
+  bool Write_File(string fileName, const GraphCSR<W>& g) const;
+  bool Read_File(string fileName, const GraphCSR<W>& g);
+
+  int Get_Num_Landmarks() const {
+    return k;
+  }
+
+  const vector<int32_t>& Get_Landmarks() const {
+    return landmarks;
+  }
+
+  // lower bound of the distance between v and t, Infinity if a landmark
+  // reaches only one of them (they are not connected)
+  Dist_t Lower_Bound(int v, int t) const {
+    const Dist_t* dv = &dist[static_cast<size_t>(v) * k];
+    const Dist_t* dt = &dist[static_cast<size_t>(t) * k];
+    Dist_t bound     = 0;
+    for (int l = 0; l < k; l++) {
+      if ((dv[l] == Infinity<Dist_t>()) || (dt[l] == Infinity<Dist_t>())) {
+        if (dv[l] != dt[l]) {
+          return Infinity<Dist_t>();
+        }
+        continue;
+      }
+      bound = max(bound, (dv[l] > dt[l]) ? dv[l] - dt[l] : dt[l] - dv[l]);
+    }
+    return bound;
+  }
+
+private:
+  int n;                    // number of graph nodes
+  int k;                    // number of landmarks
+  vector<int32_t> landmarks; // landmark nodes
+  vector<Dist_t> dist;       // dist[v * k + l]: distance of v to landmark l
+};
+
+// fct declarations
+template <typename W>
+bool Read_Edge_List(string fileName, int& nNodes, vector<Edge_t<W>>& edges);
+template <typename W, class Fct>
+bool For_Each_Edge(string fileName, int& nNodes, Fct visit);
+template <typename D>
+void printSolution(const vector<D>& dist);
+template <typename W>
+void dijkstra(const GraphMatrix<W>& G, int src);
+template <typename W>
+void dijkstra(const GraphCSR<W>& g, int src);
+template <typename W>
+SSSP_Result<W> Dijkstra_SSSP(const GraphCSR<W>& g, int src,
+                             SSSPQueue queue = SSSPQueue::AUTO);
+template <typename W, class Queue>
+void Dijkstra_Search(const GraphCSR<W>& g, Queue& queue, SSSP_Result<W>& result);
+template <typename W>
+void Weight_Range(const GraphCSR<W>& g, W& minWeight, W& maxWeight);
+template <typename W>
+Path_Result<W> Shortest_Path(const GraphCSR<W>& g, int src, int dst,
+                             const LandmarkIndex<W>* alt = nullptr);
+template <typename W>
+uint64_t Graph_Hash(const GraphCSR<W>& g);
+template <typename W>
+void Prims_MST(const GraphCSR<W>& g, int sourceNode);
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree(const GraphCSR<W>& g, int sourceNode);
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Eager(const GraphCSR<W>& g, int sourceNode);
+template <typename W>
+void Grow_Prim_Tree(const GraphCSR<W>& g, int sourceNode, ColorMask mask,
+                    IndexedHeap<tuple<W, int, int>>& heap, vector<bool>& addedNodes,
+                    vector<Color>& colors, vector<Edge_t<W>>& tree);
+template <typename W>
+vector<vector<Edge_t<W>>> Prims_MST_Forest(const GraphCSR<W>& g, ColorMask mask);
+template <typename W>
+void Print_MST_Forest(const vector<vector<Edge_t<W>>>& forest);
+template <typename W>
+vector<Edge_t<W>> Kruskal_MST_Tree(int nNodes, vector<Edge_t<W>> edges);
+template <typename W>
+vector<Edge_t<W>> Kruskal_MST_Tree(const GraphCSR<W>& g);
+template <typename W>
+vector<Edge_t<W>> Bucket_Kruskal_MST_Tree(const GraphCSR<W>& g, int64_t maxWeight);
+template <typename W>
+vector<Edge_t<W>> Boruvka_MST_Tree(const GraphCSR<W>& g, int nThreads);
+template <typename W>
+vector<Edge_t<W>> Edge_List(const GraphCSR<W>& g);
+template <typename W>
+void Print_MST(vector<Edge_t<W>> tree);
+template <typename W>
+MST_Result<W> Make_MST_Result(int nNodes, vector<Edge_t<W>> tree, int root = -1);
+bool Parse_Result_Format(const string& name, ResultFormat& format);
+template <typename W>
+void Write_MST(ResultWriter& out, const MST_Result<W>& result, ResultFormat format);
+template <typename W>
+void Write_SSSP(ResultWriter& out, const SSSP_Result<W>& result, ResultFormat format);
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Dense(const BitMatrix& conMap,
+                                       const AlignedMatrix<W>& weightMap,
+                                       const AlignedMatrix<Color>& colorMap,
+                                       int sourceNode);
+template <typename W>
+vector<typename WeightTraits<W>::Dist_t> Dijkstra_Dense(const BitMatrix& conMap,
+                                                        const AlignedMatrix<W>& weightMap,
+                                                        int src);
+template <typename W>
+bool Floyd_Warshall_APSP(const BitMatrix& conMap, const AlignedMatrix<W>& weightMap,
+                         APSP_Result<W>& result, int nThreads = 0);
+template <typename W>
+void Print_APSP(const APSP_Result<W>& result);
+template <typename W>
+bool Convert_Graph_File(string textFileName, string binaryFileName);
+void swap(int& x, int& y);
+void Benchmark_Weight_Layouts(const vector<int>& sizes);
+void Benchmark_MST(const GraphCSR<Weight_t>& g);
+void Benchmark_Dense(int nNodes);
+void Benchmark_Dynamic_MST(const GraphCSR<Weight_t>& g, int nChanges);
+void Benchmark_Queues(int nNodes);
+void Benchmark_APSP(int nNodes);
+void Benchmark_ALT(const GraphCSR<Weight_t>& g, const LandmarkIndex<Weight_t>& alt,
+                   int nQueries);
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+
+  // run the benchmarks instead of the homework, optional: graph sizes to test
+  if ((argc > 1) && (string(argv[1]) == "--bench")) {
+    vector<int> sizes;
+    for (int i = 2; i < argc; i++) {
+      sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+      sizes = {1000, 2000, 5000, 10000};
+    }
+    Benchmark_Weight_Layouts(sizes);
+    return 0;
+  }
+
+  // convert a text graph file into a binary graph file
+  if ((argc == 4) && (string(argv[1]) == "--convert")) {
+    return Convert_Graph_File<Weight_t>(argv[2], argv[3]) ? 0 : 1;
+  }
+
+  // sparse against dense kernels over a range of densities
+  if ((argc <= 3) && (argc > 1) && (string(argv[1]) == "--bench-dense")) {
+    Benchmark_Dense((argc == 3) ? atoi(argv[2]) : 2000);
+    return 0;
+  }
+
+  // Dijkstra / Kruskal with the different queues on random graphs
+  if ((argc <= 3) && (argc > 1) && (string(argv[1]) == "--bench-queues")) {
+    Benchmark_Queues((argc == 3) ? atoi(argv[2]) : 5000);
+    return 0;
+  }
+
+  // all pairs shortest paths with Floyd-Warshall
+  if ((argc <= 3) && (argc > 1) && (string(argv[1]) == "--bench-apsp")) {
+    Benchmark_APSP((argc == 3) ? atoi(argv[2]) : 2000);
+    return 0;
+  }
+  // optional: number of threads, default one per core
+  if ((argc >= 3) && (argc <= 4) && (string(argv[1]) == "--apsp")) {
+    auto startTime = high_resolution_clock::now();
+    GraphMatrix<Weight_t> G;
+    if (!G.Read_Graph_File(argv[2])) {
+      return 1;
+    }
+    cout << "Number of nodes: " << G.Size() << endl;
+    cout << "Number of edges: " << G.Get_Num_Edges() << endl;
+    APSP_Result<Weight_t> result;
+    if (!Floyd_Warshall_APSP(G.Get_Connections(), G.Get_Weights(), result,
+                             (argc == 4) ? atoi(argv[3]) : 0)) {
+      return 1;
+    }
+    Print_APSP(result);
+    duration<float> duration = high_resolution_clock::now() - startTime;
+    cout << "Total Runtime: " << duration.count() * 1000 << " ms" << endl;
+    return 0;
+  }
+
+  // point to point queries with ALT on a text graph file, the landmark tables
+  // are kept in <file>.alt and built again if missing or stale
+  // optional: number of landmarks (16), number of queries (1000)
+  if ((argc >= 3) && (argc <= 5) && (string(argv[1]) == "--alt")) {
+    int nNodes = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Read_Edge_List(argv[2], nNodes, edges)) {
+      return 1;
+    }
+    GraphCSR<Weight_t> g(nNodes, edges);
+    LandmarkIndex<Weight_t> alt;
+    string altFileName = string(argv[2]) + ".alt";
+    int nLandmarks     = (argc >= 4) ? atoi(argv[3]) : 16;
+    bool haveFile      = ifstream(altFileName).good();
+    if (!haveFile || !alt.Read_File(altFileName, g) ||
+        (alt.Get_Num_Landmarks() != max(0, min(nLandmarks, nNodes)))) {
+      auto startTime = high_resolution_clock::now();
+      alt.Build(g, nLandmarks);
+      duration<float> duration = high_resolution_clock::now() - startTime;
+      cout << "Landmarks built in " << duration.count() * 1000 << " ms" << endl;
+      if (!alt.Write_File(altFileName, g)) {
+        return 1;
+      }
+    } else {
+      cout << "Landmarks read from " << altFileName << endl;
+    }
+    Benchmark_ALT(g, alt, (argc == 5) ? atoi(argv[4]) : 1000);
+    return 0;
+  }
+
+  // compare the MST engines on a text graph file or a random graph
+  if ((argc == 3) && (string(argv[1]) == "--bench-mst")) {
+    int nNodes = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Read_Edge_List(argv[2], nNodes, edges)) {
+      return 1;
+    }
+    Benchmark_MST(GraphCSR<Weight_t>(nNodes, edges));
+    return 0;
+  }
+  if ((argc == 4) && (string(argv[1]) == "--bench-mst")) {
+    GraphMatrix<Weight_t> G(atoi(argv[2]), atof(argv[3]), {1, 99});
+    Benchmark_MST(G.Get_CSR());
+    return 0;
+  }
+
+  // DynamicMST on a text graph file or a random graph
+  if ((argc == 3) && (string(argv[1]) == "--bench-dynamic")) {
+    int nNodes = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Read_Edge_List(argv[2], nNodes, edges)) {
+      return 1;
+    }
+    Benchmark_Dynamic_MST(GraphCSR<Weight_t>(nNodes, edges), 100000);
+    return 0;
+  }
+  if ((argc == 4) && (string(argv[1]) == "--bench-dynamic")) {
+    GraphMatrix<Weight_t> G(atoi(argv[2]), atof(argv[3]), {1, 99});
+    Benchmark_Dynamic_MST(G.Get_CSR(), 100000);
+    return 0;
+  }
+
+  // Kruskal straight off the streamed edges ("-" for stdin), no graph is built
+  // if an edge is listed several times, the cheapest one is used
+  if ((argc == 3) && (string(argv[1]) == "--kruskal")) {
+    auto startTime = high_resolution_clock::now();
+    int nNodes     = 0;
+    vector<Edge_t<Weight_t>> edges;
+    bool ok = For_Each_Edge<Weight_t>(argv[2], nNodes, [&](const Edge_t<Weight_t>& e) {
+      edges.push_back(e);
+    });
+    if (!ok) {
+      return 1;
+    }
+    cout << "Running Kruskal MST algorithm:" << endl;
+    Print_MST(Kruskal_MST_Tree(nNodes, std::move(edges)));
+    duration<float> duration = high_resolution_clock::now() - startTime;
+    cout << "Total Runtime: " << duration.count() * 1000 << " ms" << endl;
+    return 0;
+  }
+
+  // parallel Boruvka on a text graph file, optional: number of threads
+  if ((argc >= 3) && (argc <= 4) && (string(argv[1]) == "--boruvka")) {
+    auto startTime = high_resolution_clock::now();
+    int nNodes     = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Read_Edge_List(argv[2], nNodes, edges)) {
+      return 1;
+    }
+    cout << "Running Boruvka MST algorithm:" << endl;
+    GraphCSR<Weight_t> g(nNodes, edges);
+    Print_MST(Boruvka_MST_Tree(g, (argc == 4) ? atoi(argv[3]) : 0));
+    duration<float> duration = high_resolution_clock::now() - startTime;
+    cout << "Total Runtime: " << duration.count() * 1000 << " ms" << endl;
+    return 0;
+  }
+
+  // MST restricted to some edge colors, e.g. --colors RG file ("-" for stdin)
+  if ((argc == 4) && (string(argv[1]) == "--colors")) {
+    ColorMask mask = Parse_Color_Mask(argv[2]);
+    if (mask == 0) {
+      cout << "Error: colors must be letters out of R, G and B" << endl;
+      return 1;
+    }
+    GraphMatrix<Weight_t> G;
+    if (!G.Read_Graph_File(argv[3])) {
+      return 1;
+    }
+    G.Prims_MST_Forest(mask);
+    return 0;
+  }
+
+  // write the minimum spanning forest / the distances from a source node of a
+  // text graph file as text, csv or bin, optional: output file, default stdout
+  if ((argc >= 4) && (argc <= 5) && (string(argv[1]) == "--mst-out")) {
+    ResultFormat format;
+    int nNodes = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Parse_Result_Format(argv[2], format)) {
+      cout << "Error: the format must be text, csv or bin" << endl;
+      return 1;
+    }
+    if (!Read_Edge_List(argv[3], nNodes, edges)) {
+      return 1;
+    }
+    GraphCSR<Weight_t> g(nNodes, edges);
+    ResultWriter out;
+    if (!out.Open((argc == 5) ? argv[4] : "-")) {
+      return 1;
+    }
+    Write_MST(out, Make_MST_Result(nNodes, Kruskal_MST_Tree(g)), format);
+    return out.Close() ? 0 : 1;
+  }
+  if ((argc >= 5) && (argc <= 6) && (string(argv[1]) == "--sssp-out")) {
+    ResultFormat format;
+    int nNodes = 0;
+    vector<Edge_t<Weight_t>> edges;
+    if (!Parse_Result_Format(argv[2], format)) {
+      cout << "Error: the format must be text, csv or bin" << endl;
+      return 1;
+    }
+    if (!Read_Edge_List(argv[3], nNodes, edges)) {
+      return 1;
+    }
+    int src = atoi(argv[4]);
+    if ((src < 0) || (src >= nNodes)) {
+      cout << "Error: no source node " << src << endl;
+      return 1;
+    }
+    GraphCSR<Weight_t> g(nNodes, edges);
+    ResultWriter out;
+    if (!out.Open((argc == 6) ? argv[5] : "-")) {
+      return 1;
+    }
+    Write_SSSP(out, Dijkstra_SSSP(g, src), format);
+    return out.Close() ? 0 : 1;
+  }
+
+  // run the MST directly on a memory mapped binary graph file
+  if ((argc == 3) && (string(argv[1]) == "--mapped")) {
+    auto startTime = high_resolution_clock::now();
+    GraphCSR<Weight_t> g;
+    if (!g.Map_Binary_File(argv[2])) {
+      return 1;
+    }
+    cout << "Number of nodes: " << g.Size() << endl;
+    cout << "Number of edges: " << g.Get_Num_Edges() << endl;
+    Prims_MST(g, 0);
+    duration<float> duration = high_resolution_clock::now() - startTime;
+    cout << "Total Runtime: " << duration.count() * 1000 << " ms" << endl;
+    return 0;
+  }
+
+  // single pass over a text graph file ("-" for stdin), nothing is stored
+  if ((argc == 3) && (string(argv[1]) == "--stats")) {
+    int nNodes       = 0;
+    int64_t nLines   = 0;
+    double sum       = 0;
+    Weight_t minCost = numeric_limits<Weight_t>::max();
+    Weight_t maxCost = numeric_limits<Weight_t>::lowest();
+    bool ok = For_Each_Edge<Weight_t>(argv[2], nNodes, [&](const Edge_t<Weight_t>& e) {
+      nLines++;
+      sum    += e.weight;
+      minCost = min(minCost, e.weight);
+      maxCost = max(maxCost, e.weight);
+    });
+    if (!ok) {
+      return 1;
+    }
+    cout << "Number of nodes: " << nNodes << endl;
+    cout << "Number of edge lines: " << nLines << endl;
+    if (nLines > 0) {
+      cout << "Cost min / max / mean: " << minCost << " / " << maxCost << " / "
+           << sum / nLines << endl;
+    }
+    return 0;
+  }
+
+  auto startTime = high_resolution_clock::now();
+
+  // optional: graph file to use, "-" reads it from stdin
+  string fileName = (argc == 2) ? argv[1] : "../testdata_mst_data.txt";
+  // GraphMatrix<Weight_t> MyGraph(10, 0.20, {1, 9});
+  GraphMatrix<Weight_t> MyGraph;
+  if (!MyGraph.Read_Graph_File(fileName)) {
+    return 1;
+  }
+
+  cout << endl;
+  cout << "########## Graph Infos ##########" << endl;
+  cout << "Number of nodes: " << (int)MyGraph.Size() << endl;
+  cout << "Number of edges: " << (int)MyGraph.Get_Num_Edges() << endl;
+  cout << "Density: " << MyGraph.Get_Density() << endl;
+  cout << endl;
+
+  MyGraph.Print();
+
+  cout << endl;
+
+  MyGraph.Prims_MST(0);
+  MyGraph.Kruskal_MST();
+
+  auto stopTime            = high_resolution_clock::now();
+  duration<float> duration = stopTime - startTime;
   // auto duration = duration_cast<microseconds>(stop - start);
   // auto myTime = duration_cast<fsec>(duration)*1000;
   cout << "Total Runtime: " << duration.count() * 1000 << " ms" << endl;
 
-  return 0;
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+GraphMatrix<W>::GraphMatrix(int32_t nNodes, float prob, vector<int> range)
+    : n(nNodes), matricesValid(true), csrValid(false) {
+  srand(time(NULL)); // seed the random number generator
+
+  // create empty 2d matricies for connections and weights
+  conMap.Resize(n);
+  Reset_Stats();
+  weightMap.Resize(n, EdgeWeight::NO_CON);
+  colorMap.Resize(n, Color::NO_COLOR);
+
+  for (int x = 0; x < n; x++) {
+    for (int y = x + 1; y < n; y++) {
+      int rCon = rand() % 101; // rand number between 0 and 100
+      // rand number between EdgeWeight::MIN and EdgeWeight::MAX
+      int rWeight = (rand() % range[1]) + range[0];
+      if (rCon < (prob * 100)) {
+        // create new color in range 1-3 (red, green, blue)
+        Color newColor  = static_cast<Color>((rand() % 3) + 1);
+        conMap.Set(x, y);
+        weightMap(x, y) = Weight_Cast<W>(rWeight);
+        colorMap(x, y)  = newColor;
+        // unidirected graph, so we need to fill the other way too
+        conMap.Set(y, x);
+        Count_Edge(x, +1);
+        Count_Edge(y, +1);
+        weightMap(y, x) = Weight_Cast<W>(rWeight);
+        colorMap(y, x)  = newColor;
+      }
+    }
+  }
+  csr      = GraphCSR<W>(conMap, weightMap, colorMap);
+  csrValid = true;
+}
+
+// -----------------------------------------------------------------------------
+// parse a decimal integer starting at p, in the spirit of std::from_chars
+// leading blanks are skipped, returns the position after the number or nullptr
+// if there is no number or it does not fit into int64_t
+inline const char* Parse_Int(const char* p, const char* end, int64_t& value) {
+  while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) {
+    p++;
+  }
+  bool negative = (p < end) && (*p == '-');
+  if (negative) {
+    p++;
+  }
+  if ((p == end) || (*p < '0') || (*p > '9')) {
+    return nullptr;
+  }
+  const char* first = p;
+  uint64_t result   = 0;
+  while ((p < end) && (static_cast<unsigned>(*p - '0') < 10)) {
+    result = result * 10 + (*p - '0');
+    p++;
+  }
+  // 19 digits always fit into uint64_t, so one check at the end is enough
+  if ((p - first > 19) || (result > uint64_t(numeric_limits<int64_t>::max()))) {
+    return nullptr; // overflow
+  }
+  value = negative ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+  return p;
+}
+
+// -----------------------------------------------------------------------------
+// true if only blanks are left until end
+inline bool Is_Blank(const char* p, const char* end) {
+  while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) {
+    p++;
+  }
+  return p == end;
+}
+
+// problem found while parsing a text graph file
+struct ParseError {
+  int64_t line;   // line number in the file, starting at 1
+  string message; // what is wrong with the line
+};
+
+// one piece of a text graph file, parsed by its own thread
+template <typename W>
+struct ParseChunk {
+  const char* begin;         // first character, always at the start of a line
+  const char* end;           // one past the last character
+  int64_t nLines;            // number of lines in the chunk
+  vector<Edge_t<W>> edges;   // edges in file order, colors not yet set
+  vector<ParseError> errors; // line numbers relative to the chunk start
+};
+
+// -----------------------------------------------------------------------------
+// parse all (i, j, cost) lines of a chunk in a single pass, the end of a line is
+// only searched for if the line turns out to be bad
+template <typename W>
+void Parse_Chunk(ParseChunk<W>& chunk, int nNodes) {
+  const char* p   = chunk.begin;
+  const char* end = chunk.end;
+  chunk.nLines    = 0;
+  chunk.edges.reserve((end - p) / 16); // rough guess: 16 characters per line
+  while (p < end) {
+    chunk.nLines++;
+
+    int64_t value[3];
+    const char* q = p;
+    for (int i = 0; (i < 3) && (q != nullptr); i++) {
+      q = Parse_Int(q, end, value[i]);
+    }
+    while ((q != nullptr) && (q < end) && ((*q == ' ') || (*q == '\t') || (*q == '\r'))) {
+      q++;
+    }
+
+    if ((q != nullptr) && ((q == end) || (*q == '\n'))) {
+      if ((value[0] < 0) || (value[0] >= nNodes) || (value[1] < 0) ||
+          (value[1] >= nNodes)) {
+        chunk.errors.push_back({chunk.nLines, "node id out of range [0, " +
+                                                  to_string(nNodes) + ")"});
+      } else {
+        Edge_t<W> edge;
+        edge.from   = value[0];
+        edge.to     = value[1];
+        edge.weight = Weight_Cast<W>(value[2]);
+        edge.color  = Color::NO_COLOR;
+        chunk.edges.push_back(edge);
+      }
+      p = q + 1;
+      continue;
+    }
+
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) {
+      eol = end;
+    }
+    if (!Is_Blank(p, eol)) { // empty lines are fine
+      chunk.errors.push_back(
+          {chunk.nLines, "malformed line \"" + string(p, min<size_t>(eol - p, 40)) +
+                             "\", expected: i j cost"});
+    }
+    p = eol + 1;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// read in a graph from a file.
+// initial integer == node size of the graph
+// remainder are integer triples: (i, j, cost), one per line
+// weights outside the range of W are clamped, malformed lines and edges with
+// node ids out of range are reported and skipped
+// the file is split at line boundaries and the pieces are parsed in parallel
+template <typename W>
+bool Read_Edge_List(string fileName, int& nNodes, vector<Edge_t<W>>& edges) {
+  MappedFile file;
+  if (!file.Open(fileName)) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  const char* begin = file.Data();
+  const char* end   = file.Data() + file.Size();
+
+  // first line: node size of the graph
+  const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+  if (eol == nullptr) {
+    eol = end;
+  }
+  int64_t value;
+  const char* p = Parse_Int(begin, eol, value);
+  if ((p == nullptr) || !Is_Blank(p, eol) || (value < 0) ||
+      (value >= numeric_limits<int32_t>::max())) {
+    cout << "Error: " << fileName << ":1: expected the number of nodes" << endl;
+    return false;
+  }
+  nNodes = value;
+  begin  = min(eol + 1, end);
+
+  // one chunk per thread, but not smaller than ~1 MB
+  const size_t minChunkSize = 1 << 20;
+  size_t nChunks = max<size_t>(1, min<size_t>(thread::hardware_concurrency(),
+                                              (end - begin) / minChunkSize));
+  vector<ParseChunk<W>> chunks(nChunks);
+  const char* chunkBegin = begin;
+  for (size_t i = 0; i < nChunks; i++) {
+    const char* chunkEnd = end;
+    if (i + 1 < nChunks) {
+      // move the split point behind the next line break
+      const char* split = max(chunkBegin, begin + (end - begin) / nChunks * (i + 1));
+      const char* nl    = static_cast<const char*>(memchr(split, '\n', end - split));
+      chunkEnd          = (nl == nullptr) ? end : nl + 1;
+    }
+    chunks[i].begin = chunkBegin;
+    chunks[i].end   = chunkEnd;
+    chunkBegin      = chunkEnd;
+  }
+
+  vector<thread> workers;
+  for (size_t i = 1; i < nChunks; i++) {
+    workers.push_back(thread(Parse_Chunk<W>, std::ref(chunks[i]), nNodes));
+  }
+  Parse_Chunk<W>(chunks[0], nNodes);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // merge in file order, line numbers of the chunks are relative
+  size_t nEdges = 0;
+  for (const auto& chunk : chunks) {
+    nEdges += chunk.edges.size();
+  }
+  edges.clear();
+  if (nChunks > 1) {
+    edges.reserve(nEdges);
+  }
+  vector<ParseError> errors;
+  int64_t lineOffset = 1; // the node size line
+  if (nChunks == 1) {
+    edges.swap(chunks[0].edges);
+  }
+  for (const auto& chunk : chunks) {
+    edges.insert(edges.end(), chunk.edges.begin(), chunk.edges.end());
+    for (const auto& error : chunk.errors) {
+      errors.push_back({lineOffset + error.line, error.message});
+    }
+    lineOffset += chunk.nLines;
+  }
+
+  // create new color in range 1-3 (red, green, blue) as file does not specify
+  // done after merging, so that the colors don't depend on the thread count
+  minstd_rand colorGen(rand());
+  for (auto& edge : edges) {
+    edge.color = static_cast<Color>((colorGen() % 3) + 1);
+  }
+
+  const size_t maxReported = 10;
+  for (size_t i = 0; i < min(errors.size(), maxReported); i++) {
+    cout << "Error: " << fileName << ":" << errors[i].line << ": " << errors[i].message
+         << endl;
+  }
+  if (errors.size() > maxReported) {
+    cout << "Error: " << errors.size() - maxReported << " more bad lines in "
+         << fileName << endl;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+bool EdgeReader::Open(string name) {
+  Close();
+  fileName = name;
+  if (fileName == "-") {
+    file = stdin;
+  } else {
+    file = fopen(fileName.c_str(), "rb");
+  }
+  if (file == nullptr) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  eof = false;
+
+  // first line: node size of the graph
+  const char* begin;
+  const char* end;
+  int64_t value;
+  const char* p = Next_Line(begin, end) ? Parse_Int(begin, end, value) : nullptr;
+  if ((p == nullptr) || !Is_Blank(p, end) || (value < 0) ||
+      (value >= numeric_limits<int32_t>::max())) {
+    cout << "Error: " << fileName << ":1: expected the number of nodes" << endl;
+    Close();
+    return false;
+  }
+  nNodes = value;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+void EdgeReader::Close() {
+  if ((file != nullptr) && (file != stdin)) {
+    fclose(file);
+  }
+  file = nullptr;
+  pos  = 0;
+  len  = 0;
+  eof  = true;
+  line = 0;
+}
+
+// -----------------------------------------------------------------------------
+// find the next line in the buffer, refill it if the line is incomplete
+// lines longer than the buffer are reported and skipped
+bool EdgeReader::Next_Line(const char*& begin, const char*& end) {
+  size_t scan = pos; // everything before was already searched for '\n'
+  bool tooLong = false;
+  while (true) {
+    const char* nl = static_cast<const char*>(
+        memchr(buffer.data() + scan, '\n', len - scan));
+    if ((nl != nullptr) || (eof && (pos < len))) {
+      line++;
+      begin = buffer.data() + pos;
+      end   = (nl != nullptr) ? nl : buffer.data() + len;
+      pos   = (nl != nullptr) ? (end - buffer.data()) + 1 : len;
+      if (!tooLong) {
+        return true;
+      }
+      Report("line longer than " + to_string(buffer.size()) + " characters");
+      tooLong = false;
+      scan    = pos;
+      continue;
+    }
+    if (eof) {
+      if (tooLong) {
+        line++;
+        Report("line longer than " + to_string(buffer.size()) + " characters");
+      }
+      return false;
+    }
+    // keep the incomplete line, drop it if it fills the whole buffer
+    if (pos == 0 && len == buffer.size()) {
+      tooLong = true;
+      len     = 0;
+    }
+    memmove(buffer.data(), buffer.data() + pos, len - pos);
+    len -= pos;
+    pos  = 0;
+    scan = len;
+    size_t nRead = fread(buffer.data() + len, 1, buffer.size() - len, file);
+    len += nRead;
+    eof = (nRead == 0);
+  }
+}
+
+// -----------------------------------------------------------------------------
+void EdgeReader::Report(const string& message) {
+  // the first few problems are enough to find out what is wrong with a file
+  const int64_t maxReported = 10;
+  nErrors++;
+  if (nErrors <= maxReported) {
+    cout << "Error: " << fileName << ":" << line << ": " << message << endl;
+  } else if (nErrors == maxReported + 1) {
+    cout << "Error: more bad lines in " << fileName << " not reported" << endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool EdgeReader::Next(Edge_t<W>& edge) {
+  const char* begin;
+  const char* end;
+  while (Next_Line(begin, end)) {
+    int64_t value[3];
+    const char* p = begin;
+    for (int i = 0; (i < 3) && (p != nullptr); i++) {
+      p = Parse_Int(p, end, value[i]);
+    }
+    if ((p == nullptr) || !Is_Blank(p, end)) {
+      if (!Is_Blank(begin, end)) { // empty lines are fine
+        Report("malformed line \"" + string(begin, min<size_t>(end - begin, 40)) +
+               "\", expected: i j cost");
+      }
+    } else if ((value[0] < 0) || (value[0] >= nNodes) || (value[1] < 0) ||
+               (value[1] >= nNodes)) {
+      Report("node id out of range [0, " + to_string(nNodes) + ")");
+    } else {
+      edge.from   = value[0];
+      edge.to     = value[1];
+      edge.weight = Weight_Cast<W>(value[2]);
+      edge.color  = Color::NO_COLOR;
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// stream all edges of a text graph file into visit(const Edge_t<W>&) without
+// keeping them, nNodes is set before the first call
+template <typename W, class Fct>
+bool For_Each_Edge(string fileName, int& nNodes, Fct visit) {
+  EdgeReader reader;
+  if (!reader.Open(fileName)) {
+    return false;
+  }
+  nNodes = reader.Get_Num_Nodes();
+  Edge_t<W> edge;
+  while (reader.Next(edge)) {
+    visit(static_cast<const Edge_t<W>&>(edge));
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ResultWriter::Open(string fileName) {
+  Close();
+  if (fileName == "-") {
+    file = stdout;
+  } else {
+    file = fopen(fileName.c_str(), "wb");
+  }
+  if (file == nullptr) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  ok = true;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ResultWriter::Close() {
+  if (file == nullptr) {
+    return ok;
+  }
+  Flush();
+  if (file == stdout) {
+    ok = (fflush(file) == 0) && ok;
+  } else {
+    ok = (fclose(file) == 0) && ok;
+  }
+  file = nullptr;
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+void ResultWriter::Flush() {
+  if ((file != nullptr) && (len > 0)) {
+    ok = (fwrite(buffer.data(), 1, len, file) == len) && ok;
+  }
+  len = 0;
+}
+
+// -----------------------------------------------------------------------------
+void ResultWriter::Put_Bytes(const void* data, size_t bytes) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    if (len == buffer.size()) {
+      Flush();
+    }
+    size_t n = min(bytes, buffer.size() - len);
+    memcpy(&buffer[len], p, n);
+    len   += n;
+    p     += n;
+    bytes -= n;
+  }
+}
+
+// -----------------------------------------------------------------------------
+void ResultWriter::Put_Int(int64_t value, int minDigits) {
+  // digits from the back, as unsigned so that the lowest value works as well
+  char digits[24];
+  char* p         = digits + sizeof(digits);
+  uint64_t number = (value < 0) ? 0 - static_cast<uint64_t>(value) : value;
+  do {
+    *--p    = static_cast<char>('0' + number % 10);
+    number /= 10;
+  } while (number > 0);
+  while ((value >= 0) && (digits + sizeof(digits) - p < minDigits) && (p > digits)) {
+    *--p = '0';
+  }
+  if (value < 0) {
+    *--p = '-';
+  }
+  Put_Bytes(p, digits + sizeof(digits) - p);
+}
+
+// -----------------------------------------------------------------------------
+void ResultWriter::Put_Double(double value, int precision) {
+  char text[40];
+  int n = snprintf(text, sizeof(text), "%.*g", precision, value);
+  Put_Bytes(text, static_cast<size_t>(max(n, 0)));
+}
+
+// -----------------------------------------------------------------------------
+// a file is parsed in parallel chunks (Read_Edge_List) and the CSR is built
+// straight from the edge list, the matrices follow on first use.
+// "-" reads the graph from stdin, the edges are streamed straight into the
+// matrices then, so only the matrices and the read buffer are kept in memory
+template <typename W>
+bool GraphMatrix<W>::Read_Graph_File(string fileName) {
+  if (fileName != "-") {
+    int nNodes;
+    vector<Edge_t<W>> edges;
+    if (!Read_Edge_List(fileName, nNodes, edges)) {
+      *this = GraphMatrix();
+      return false;
+    }
+    n   = nNodes;
+    csr = GraphCSR<W>(n, edges);
+    Reset_Stats();
+    for (int x = 0; x < n; x++) {
+      degreeHist[0]--;
+      degree[x] = csr.End(x) - csr.Begin(x);
+      degreeHist[degree[x]]++;
+      nEdges += degree[x];
+    }
+    conMap        = BitMatrix();
+    weightMap     = AlignedMatrix<W>();
+    colorMap      = AlignedMatrix<Color>();
+    matricesValid = false;
+    csrValid      = true;
+    return true;
+  }
+
+  EdgeReader reader;
+  if (!reader.Open(fileName)) {
+    *this = GraphMatrix();
+    return false;
+  }
+  n = reader.Get_Num_Nodes();
+
+  conMap.Resize(n);
+  Reset_Stats();
+  weightMap.Resize(n, EdgeWeight::NO_CON);
+  colorMap.Resize(n, Color::NO_COLOR);
+
+  // create new color in range 1-3 (red, green, blue) as file does not specify
+  minstd_rand colorGen(rand());
+  Edge_t<W> edge;
+  while (reader.Next(edge)) {
+    int thisNode     = edge.from;
+    int neighborNode = edge.to;
+    Color newColor   = static_cast<Color>((colorGen() % 3) + 1);
+    if (thisNode == neighborNode) {
+      continue; // we don't allow self-loop
+    }
+    // the file lists most edges in both directions, count each one only once
+    if (!conMap.Get(thisNode, neighborNode)) {
+      conMap.Set(thisNode, neighborNode);
+      Count_Edge(thisNode, +1);
+    }
+    if (!conMap.Get(neighborNode, thisNode)) {
+      conMap.Set(neighborNode, thisNode);
+      Count_Edge(neighborNode, +1);
+    }
+    weightMap(thisNode, neighborNode) = edge.weight;
+    colorMap(thisNode, neighborNode)  = newColor;
+    weightMap(neighborNode, thisNode) = edge.weight;
+    colorMap(neighborNode, thisNode)  = newColor;
+  }
+
+  // built from the matrices on first use
+  matricesValid = true;
+  csrValid      = false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// CSR from an edge list, counting sort by source node keeps the file order
+// within a row, so that duplicates can be merged with "last one wins"
+template <typename W>
+GraphCSR<W>::GraphCSR(int nNodes, const vector<Edge_t<W>>& edges) : n(nNodes) {
+  offsets.assign(n + 1, 0);
+  for (const auto& edge : edges) {
+    offsets[edge.from + 1]++;
+    offsets[edge.to + 1]++;
+  }
+  for (int i = 0; i < n; i++) {
+    offsets[i + 1] += offsets[i];
+  }
+
+  // scatter both directions of every edge into their rows
+  vector<int32_t> fill(offsets.begin(), offsets.end() - 1);
+  vector<int> order(offsets[n]); // edge list index per slot
+  vector<int> other(offsets[n]); // neighbor node per slot
+  for (int i = 0; i < static_cast<int>(edges.size()); i++) {
+    order[fill[edges[i].from]]  = i;
+    other[fill[edges[i].from]++] = edges[i].to;
+    order[fill[edges[i].to]]    = i;
+    other[fill[edges[i].to]++]   = edges[i].from;
+  }
+
+  // sort each row by neighbor and drop duplicates, keeping the last edge
+  targets.reserve(offsets[n]);
+  weights.reserve(offsets[n]);
+  colors.reserve(offsets[n]);
+  vector<int32_t> rowStart(n + 1, 0);
+  vector<int> slots;
+  for (int x = 0; x < n; x++) {
+    rowStart[x] = targets.size();
+    slots.resize(offsets[x + 1] - offsets[x]);
+    for (int k = 0; k < static_cast<int>(slots.size()); k++) {
+      slots[k] = offsets[x] + k;
+    }
+    stable_sort(slots.begin(), slots.end(),
+                [&other](int a, int b) { return other[a] < other[b]; });
+    for (int k = 0; k < static_cast<int>(slots.size()); k++) {
+      int slot = slots[k];
+      if ((k + 1 < static_cast<int>(slots.size())) &&
+          (other[slots[k + 1]] == other[slot])) {
+        continue; // a later edge to the same neighbor overrides this one
+      }
+      if (other[slot] == x) {
+        continue; // we don't allow self-loop
+      }
+      targets.push_back(other[slot]);
+      weights.push_back(edges[order[slot]].weight);
+      colors.push_back(edges[order[slot]].color);
+    }
+  }
+  rowStart[n] = targets.size();
+  offsets.swap(rowStart);
+  m = targets.size();
+  Bind();
+}
+
+// -----------------------------------------------------------------------------
+// CSR from the connectivity matrix, only used after the matrix was modified
+template <typename W>
+GraphCSR<W>::GraphCSR(const BitMatrix& conMap,
+                      const AlignedMatrix<W>& weightMap,
+                      const AlignedMatrix<Color>& colorMap)
+    : n(weightMap.Size()) {
+  offsets.assign(n + 1, 0);
+  targets.reserve(conMap.Count());
+  weights.reserve(conMap.Count());
+  colors.reserve(conMap.Count());
+  for (int x = 0; x < n; x++) {
+    offsets[x] = targets.size();
+    // only visit the set bits of the row
+    conMap.For_Each_In_Row(x, [&](int y) {
+      targets.push_back(y);
+      weights.push_back(weightMap(x, y));
+      colors.push_back(colorMap(x, y));
+    });
+  }
+  offsets[n] = targets.size();
+  m          = targets.size();
+  Bind();
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool GraphCSR<W>::Write_Binary_File(string fileName) const {
+  GraphFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+  header.version     = GRAPH_FILE_VERSION;
+  header.byteOrder   = GRAPH_BYTE_ORDER;
+  header.weightBytes = sizeof(W);
+  header.weightKind  = Weight_Kind<W>();
+  header.nNodes      = n;
+  header.nEdges      = m;
+  header.offsetsPos  = Align_64(sizeof(header));
+  header.targetsPos  = Align_64(header.offsetsPos + (n + 1) * sizeof(int32_t));
+  header.weightsPos  = Align_64(header.targetsPos + m * sizeof(int32_t));
+  header.colorsPos   = Align_64(header.weightsPos + m * sizeof(W));
+  header.fileSize    = header.colorsPos + m * sizeof(Color);
+
+  ofstream file(fileName, ios::binary | ios::trunc);
+  if (!file.is_open()) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  // write an array at position pos, zero padding everything before
+  auto write = [&file](int64_t pos, const void* data, size_t bytes) {
+    while (static_cast<int64_t>(file.tellp()) < pos) {
+      file.put(0);
+    }
+    file.write(static_cast<const char*>(data), bytes);
+  };
+  write(0, &header, sizeof(header));
+  write(header.offsetsPos, pOffsets, (n + 1) * sizeof(int32_t));
+  write(header.targetsPos, pTargets, m * sizeof(int32_t));
+  write(header.weightsPos, pWeights, m * sizeof(W));
+  write(header.colorsPos, pColors, m * sizeof(Color));
+  return file.good();
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool GraphCSR<W>::Map_Binary_File(string fileName) {
+  shared_ptr<MappedFile> file(new MappedFile);
+  if (!file->Open(fileName)) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+
+  // check that the file was written for this weight type on this machine
+  GraphFileHeader header;
+  if (file->Size() < sizeof(header)) {
+    cout << "Error: " << fileName << " is not a binary graph file" << endl;
+    return false;
+  }
+  memcpy(&header, file->Data(), sizeof(header));
+  if (memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+    cout << "Error: " << fileName << " is not a binary graph file" << endl;
+    return false;
+  }
+  if ((header.version != GRAPH_FILE_VERSION) ||
+      (header.byteOrder != GRAPH_BYTE_ORDER)) {
+    cout << "Error: unsupported version / byte order of " << fileName << endl;
+    return false;
+  }
+  if ((header.weightBytes != sizeof(W)) || (header.weightKind != Weight_Kind<W>())) {
+    cout << "Error: weight type of " << fileName << " does not match" << endl;
+    return false;
+  }
+  // every array lies behind the header inside the file, aligned to its type
+  auto inFile = [&header](int64_t pos, int64_t count, int64_t size) {
+    return (pos >= static_cast<int64_t>(sizeof(header))) && (pos % size == 0) &&
+           (pos <= header.fileSize) && (count <= (header.fileSize - pos) / size);
+  };
+  if ((header.fileSize != static_cast<int64_t>(file->Size())) ||
+      (header.nNodes < 0) || (header.nNodes >= numeric_limits<int32_t>::max()) ||
+      (header.nEdges < 0) || (header.nEdges > numeric_limits<int32_t>::max()) ||
+      !inFile(header.offsetsPos, header.nNodes + 1, sizeof(int32_t)) ||
+      !inFile(header.targetsPos, header.nEdges, sizeof(int32_t)) ||
+      !inFile(header.weightsPos, header.nEdges, sizeof(W)) ||
+      !inFile(header.colorsPos, header.nEdges, sizeof(Color))) {
+    cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+    return false;
+  }
+
+  // offsets run from 0 to nEdges without going down, targets are nodes
+  const int32_t* fileOffsets =
+      reinterpret_cast<const int32_t*>(file->Data() + header.offsetsPos);
+  const int32_t* fileTargets =
+      reinterpret_cast<const int32_t*>(file->Data() + header.targetsPos);
+  bool valid = (fileOffsets[0] == 0) &&
+               (fileOffsets[header.nNodes] == header.nEdges);
+  for (int64_t x = 0; valid && (x < header.nNodes); x++) {
+    valid = fileOffsets[x] <= fileOffsets[x + 1];
+  }
+  for (int64_t e = 0; valid && (e < header.nEdges); e++) {
+    valid = (fileTargets[e] >= 0) && (fileTargets[e] < header.nNodes);
+  }
+  if (!valid) {
+    cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+    return false;
+  }
+
+  n = header.nNodes;
+  m = header.nEdges;
+  offsets.clear();
+  targets.clear();
+  weights.clear();
+  colors.clear();
+  mapping  = file;
+  pOffsets = fileOffsets;
+  pTargets = fileTargets;
+  pWeights = reinterpret_cast<const W*>(file->Data() + header.weightsPos);
+  pColors  = reinterpret_cast<const Color*>(file->Data() + header.colorsPos);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// convert a text graph file of (i, j, cost) triples into a binary graph file
+template <typename W>
+bool Convert_Graph_File(string textFileName, string binaryFileName) {
+  int nNodes;
+  vector<Edge_t<W>> edges;
+  if (!Read_Edge_List(textFileName, nNodes, edges)) {
+    return false;
+  }
+  GraphCSR<W> g(nNodes, edges);
+  return g.Write_Binary_File(binaryFileName);
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Print() {
+  Build_Matrices();
+  cout << "Colored Connectivity Map: " << endl;
+  cout << "      ";
+  // print column indices
+  for (int i = 0; i < n; i++) {
+    cout << " " << std::setfill('0') << std::setw(2);
+    cout << i << "";
+  }
+  cout << endl;
+  for (int x = 0; x < n; x++) {
+    cout << "N " << std::setfill('0') << std::setw(2) << x << ": "; // print row
+                                                                    // indices
+    const W* row = weightMap.Row(x);
+    for (int y = 0; y < n; y++) {
+      if (x == y) {
+        cout << " \\ ";
+      } else if (conMap.Get(x, y)) {
+        // see
+        // https://stackoverflow.com/questions/4842424/list-of-ansi-color-escape-sequences
+        // for anso color coding
+        switch (colorMap(x, y)) {
+        case Color::RED:
+          cout << "\033[31m";
+          break;
+        case Color::GREEN:
+          cout << "\033[32m";
+          break;
+        case Color::BLUE:
+          cout << "\033[34m";
+          break;
+        }
+        cout << " " << std::setfill('0') << std::setw(2) << +row[y];
+        cout << "\033[0m";
+      } else {
+        cout << "   ";
+      }
+    }
+    cout << endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Print_Color() {
+  Build_Matrices();
+  cout << "Color Map: " << endl;
+  cout << "  ";
+  // print column indices
+  for (int i = 0; i < n; i++) {
+    cout << " " << i << " ";
+  }
+  cout << endl;
+  for (int x = 0; x < n; x++) {
+    cout << x << ":"; // print row indices
+    for (int y = 0; y < n; y++) {
+      if (x == y) {
+        cout << " \\ ";
+      } else if (conMap.Get(x, y)) {
+        cout << " " << colorMap(x, y) << " ";
+      } else {
+        cout << "   ";
+      }
+    }
+    cout << endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+vector<int> GraphMatrix<W>::Get_Neighbors(int x) {
+  const GraphCSR<W>& g = Get_CSR();
+  vector<int> neighbors;
+  neighbors.reserve(g.Neighbors(x).Size());
+  for (auto nb : g.Neighbors(x)) {
+    neighbors.push_back(nb.node);
+  }
+  return neighbors;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+const GraphCSR<W>& GraphMatrix<W>::Get_CSR() const {
+  if (!csrValid) {
+    csr      = GraphCSR<W>(conMap, weightMap, colorMap);
+    csrValid = true;
+  }
+  return csr;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Build_Matrices() const {
+  if (matricesValid) {
+    return;
+  }
+  conMap.Resize(n);
+  weightMap.Resize(n, EdgeWeight::NO_CON);
+  colorMap.Resize(n, Color::NO_COLOR);
+  for (int x = 0; x < n; x++) {
+    for (auto nb : csr.Neighbors(x)) {
+      conMap.Set(x, nb.node);
+      weightMap(x, nb.node) = nb.weight;
+      colorMap(x, nb.node)  = nb.color;
+    }
+  }
+  matricesValid = true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Print_Neighbors(int x) {
+  cout << "Neighbors of " << x << ": " << endl;
+  for (auto nb : Neighbors(x)) {
+    cout << x << "->" << +nb.weight << "->" << nb.node << endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Prims_MST(int sourceNode) {
+  if (Is_Dense()) {
+    cout << "Running Prims MST algorithm:" << endl;
+    Print_MST(Prims_MST_Tree_Dense(Get_Connections(), Get_Weights(), Get_Colors(),
+                                   sourceNode));
+  } else {
+    ::Prims_MST(Get_CSR(), sourceNode);
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Kruskal_MST(void) {
+  cout << "Running Kruskal MST algorithm:" << endl;
+  Print_MST(Kruskal_MST_Tree(Get_CSR()));
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Boruvka_MST(int nThreads) {
+  cout << "Running Boruvka MST algorithm:" << endl;
+  Print_MST(Boruvka_MST_Tree(Get_CSR(), nThreads));
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void GraphMatrix<W>::Prims_MST_Forest(ColorMask mask) {
+  cout << "Running Prims MST algorithm on the colors";
+  for (Color c : {Color::RED, Color::GREEN, Color::BLUE}) {
+    if (mask & Color_Bit(c)) {
+      cout << " " << c;
+    }
+  }
+  cout << ":" << endl;
+  Print_MST_Forest(::Prims_MST_Forest(Get_CSR(), mask));
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void Prims_MST(const GraphCSR<W>& g, int sourceNode) {
+  cout << "Running Prims MST algorithm:" << endl;
+  Print_MST(Prims_MST_Tree_Eager(g, sourceNode));
+}
+
+// -----------------------------------------------------------------------------
+// strict order of the edges used by all MST algorithms: weight, then the lower
+// and the higher node. With no ties left the MST is unique, so every algorithm
+// finds the same tree. Expects the lower node in from.
+template <typename W>
+inline bool MST_Less(const Edge_t<W>& a, const Edge_t<W>& b) {
+  if (a.weight != b.weight) {
+    return a.weight < b.weight;
+  }
+  if (a.from != b.from) {
+    return a.from < b.from;
+  }
+  return a.to < b.to;
+}
+
+// -----------------------------------------------------------------------------
+// lazy Prim, returns the tree edges (parent, child) of the component of
+// sourceNode in the order they were added
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree(const GraphCSR<W>& g, int sourceNode) {
+  // The priority_queue stores the candidate edges (weight, lower node, higher
+  // node, color), so that ties are broken in the order of MST_Less
+  typedef tuple<W, int, int, Color> Item_t;
+  priority_queue<Item_t, vector<Item_t>, greater<Item_t>> q;
+
+  vector<bool> addedNodes(g.Size(), false);
+  vector<Edge_t<W>> tree;
+  if ((sourceNode < 0) || (sourceNode >= g.Size())) {
+    return tree;
+  }
+
+  // add a node to the tree and push all edges leaving the tree
+  auto addNode = [&](int x) {
+    addedNodes[x] = true;
+    for (auto nb : g.Neighbors(x)) {
+      if (addedNodes[nb.node] == false) {
+        q.push(make_tuple(nb.weight, min(x, nb.node), max(x, nb.node), nb.color));
+      }
+    }
+  };
+  addNode(sourceNode);
+
+  while (!q.empty()) {
+    // Select the edge with minimum cost
+    Item_t item = q.top();
+    q.pop();
+    int lo = get<1>(item);
+    int hi = get<2>(item);
+
+    // skip edges between two nodes already in the minimum spanning tree
+    if (addedNodes[lo] && addedNodes[hi]) {
+      continue;
+    }
+    Edge_t<W> edge;
+    edge.from   = addedNodes[lo] ? lo : hi;
+    edge.to     = addedNodes[lo] ? hi : lo;
+    edge.weight = get<0>(item);
+    edge.color  = get<3>(item);
+    tree.push_back(edge);
+    addNode(edge.to);
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// eager Prim, every node outside the tree keeps only its cheapest edge to the
+// tree in an indexed heap: at most n entries and exactly one pop per node.
+// Same tie breaking as the lazy version, so both return the same tree.
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Eager(const GraphCSR<W>& g, int sourceNode) {
+  IndexedHeap<tuple<W, int, int>> heap(g.Size());
+  vector<bool> addedNodes(g.Size(), false);
+  vector<Color> colors(g.Size());
+  vector<Edge_t<W>> tree;
+  if ((sourceNode >= 0) && (sourceNode < g.Size())) {
+    Grow_Prim_Tree(g, sourceNode, ALL_COLORS, heap, addedNodes, colors, tree);
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// add the eager Prim tree of sourceNode to tree, only edges with a color in
+// mask are used. Nodes marked in addedNodes are taken as part of another tree.
+// The heap (keys (weight, lower node, higher node)) is empty again at the end.
+template <typename W>
+void Grow_Prim_Tree(const GraphCSR<W>& g, int sourceNode, ColorMask mask,
+                    IndexedHeap<tuple<W, int, int>>& heap, vector<bool>& addedNodes,
+                    vector<Color>& colors, vector<Edge_t<W>>& tree) {
+  typedef tuple<W, int, int> Key_t;
+
+  int thisNode = sourceNode;
+  while (true) {
+    addedNodes[thisNode] = true;
+    // lower the key of all neighbors outside the tree
+    for (auto nb : g.Neighbors(thisNode)) {
+      if (!addedNodes[nb.node] && (mask & Color_Bit(nb.color))) {
+        Key_t key(nb.weight, min(thisNode, nb.node), max(thisNode, nb.node));
+        if (heap.Push(nb.node, key)) {
+          colors[nb.node] = nb.color;
+        }
+      }
+    }
+    if (heap.Empty()) {
+      break;
+    }
+    Key_t key = heap.Get_Key(heap.Top());
+    thisNode  = heap.Pop();
+
+    Edge_t<W> edge;
+    edge.from   = (get<1>(key) == thisNode) ? get<2>(key) : get<1>(key);
+    edge.to     = thisNode;
+    edge.weight = get<0>(key);
+    edge.color  = colors[thisNode];
+    tree.push_back(edge);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// minimum spanning forest of the subgraph with the colors in mask, without
+// copying the graph: one tree per connected component of the subgraph, in the
+// order of their lowest node. A node without such edges is a tree of its own.
+template <typename W>
+vector<vector<Edge_t<W>>> Prims_MST_Forest(const GraphCSR<W>& g, ColorMask mask) {
+  IndexedHeap<tuple<W, int, int>> heap(g.Size());
+  vector<bool> addedNodes(g.Size(), false);
+  vector<Color> colors(g.Size());
+  vector<vector<Edge_t<W>>> forest;
+  for (int x = 0; x < g.Size(); x++) {
+    if (!addedNodes[x]) {
+      forest.push_back(vector<Edge_t<W>>());
+      Grow_Prim_Tree(g, x, mask, heap, addedNodes, colors, forest.back());
+    }
+  }
+  return forest;
+}
+
+// -----------------------------------------------------------------------------
+// print every tree of a forest with more than one node like Print_MST and the
+// number of components
+template <typename W>
+void Print_MST_Forest(const vector<vector<Edge_t<W>>>& forest) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  Dist_t forest_cost = 0;
+  int nIsolated      = 0;
+  int component      = 0;
+  for (const auto& tree : forest) {
+    component++;
+    if (tree.empty()) {
+      nIsolated++;
+      continue;
+    }
+    cout << "Component " << component << " (" << tree.size() + 1 << " nodes):" << endl;
+    for (const auto& edge : tree) {
+      forest_cost = Saturating_Add(forest_cost, edge.weight);
+    }
+    Print_MST(tree);
+  }
+  cout << "Number of components: " << forest.size() << " (" << nIsolated
+       << " single nodes)" << endl;
+  cout << "Total MST Forest Distance: " << +forest_cost << endl;
+}
+
+// -----------------------------------------------------------------------------
+// filter-Kruskal (Osipov, Sanders, Singler): split the edges at a random pivot,
+// solve the lighter part first and drop every heavier edge that already
+// connects one set before looking at the rest. Only small parts get sorted.
+template <typename W, class Gen>
+void Filter_Kruskal(Edge_t<W>* first, Edge_t<W>* last, DisjointSets& sets,
+                    vector<Edge_t<W>>& tree, int nNodes, Gen& gen) {
+  const ptrdiff_t sortSize = 1024;
+
+  while (first != last) {
+    if (static_cast<int>(tree.size()) >= nNodes - 1) {
+      return; // tree is complete, the remaining edges are never looked at
+    }
+    if (last - first <= sortSize) {
+      // plain Kruskal
+      sort(first, last, MST_Less<W>);
+      for (Edge_t<W>* e = first; e != last; e++) {
+        if (sets.Union(e->from, e->to)) {
+          tree.push_back(*e);
+        }
+      }
+      return;
+    }
+
+    // three way split: lighter than, equal to and heavier than the pivot
+    Edge_t<W> pivot = first[gen() % (last - first)];
+    Edge_t<W>* mid  = partition(first, last, [&pivot](const Edge_t<W>& e) {
+      return MST_Less(e, pivot);
+    });
+    Edge_t<W>* high = partition(mid, last, [&pivot](const Edge_t<W>& e) {
+      return !MST_Less(pivot, e);
+    });
+
+    Filter_Kruskal(first, mid, sets, tree, nNodes, gen);
+    // all equal edges connect the same two nodes, at most one of them is used
+    if (sets.Union(pivot.from, pivot.to)) {
+      tree.push_back(*mid);
+    }
+
+    // keep only the heavier edges between different sets
+    first = high;
+    last  = partition(high, last, [&sets](const Edge_t<W>& e) {
+      return sets.Find(e.from) != sets.Find(e.to);
+    });
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Kruskal on a flat edge list, returns a minimum spanning forest if the graph
+// is not connected. Edges are stored with the lower node first. Parallel edges
+// are fine, the cheapest one is used.
+template <typename W>
+vector<Edge_t<W>> Kruskal_MST_Tree(int nNodes, vector<Edge_t<W>> edges) {
+  // undirected edges: lower node first, self-loops are never part of a tree
+  size_t nKept = 0;
+  for (auto edge : edges) {
+    if (edge.from != edge.to) {
+      if (edge.from > edge.to) {
+        swap(edge.from, edge.to);
+      }
+      edges[nKept++] = edge;
+    }
+  }
+  edges.resize(nKept);
+
+  DisjointSets sets(nNodes);
+  vector<Edge_t<W>> tree;
+  tree.reserve(max(nNodes - 1, 0));
+  minstd_rand pivotGen(1);
+  Filter_Kruskal(edges.data(), edges.data() + edges.size(), sets, tree, nNodes,
+                 pivotGen);
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// Kruskal on the edges of a CSR graph, small non-negative integer weights use
+// the bucket version, everything else the filter Kruskal
+template <typename W>
+vector<Edge_t<W>> Kruskal_MST_Tree(const GraphCSR<W>& g) {
+  W minWeight, maxWeight;
+  Weight_Range(g, minWeight, maxWeight);
+  if (numeric_limits<W>::is_integer && (minWeight >= 0) &&
+      (maxWeight <= BUCKET_KRUSKAL_MAX_WEIGHT)) {
+    return Bucket_Kruskal_MST_Tree(g, static_cast<int64_t>(maxWeight));
+  }
+  return Kruskal_MST_Tree(g.Size(), Edge_List(g));
+}
+
+// -----------------------------------------------------------------------------
+// Kruskal without comparisons for integer weights 0..maxWeight: a counting
+// sort by weight over the CSR rows (sorted by neighbor) puts the edges into
+// MST_Less order in O(m + maxWeight), so the tree is the same as for all the
+// other MST algorithms. Stops as soon as the tree is complete.
+template <typename W>
+vector<Edge_t<W>> Bucket_Kruskal_MST_Tree(const GraphCSR<W>& g, int64_t maxWeight) {
+  int n = g.Size();
+
+  // first edge per weight
+  vector<int64_t> start(maxWeight + 2, 0);
+  for (int x = 0; x < n; x++) {
+    for (auto nb : g.Neighbors(x)) {
+      if (x < nb.node) {
+        start[static_cast<int64_t>(nb.weight) + 1]++;
+      }
+    }
+  }
+  for (int64_t w = 0; w <= maxWeight; w++) {
+    start[w + 1] += start[w];
+  }
+  vector<Edge_t<W>> edges(start[maxWeight + 1]);
+  for (int x = 0; x < n; x++) {
+    for (auto nb : g.Neighbors(x)) {
+      if (x < nb.node) {
+        int64_t& slot  = start[static_cast<int64_t>(nb.weight)];
+        Edge_t<W> edge = {x, nb.node, nb.weight, nb.color};
+        edges[slot++]  = edge;
+      }
+    }
+  }
+
+  DisjointSets sets(n);
+  vector<Edge_t<W>> tree;
+  tree.reserve(max(n - 1, 0));
+  for (size_t i = 0; (i < edges.size()) && (tree.size() + 1 < static_cast<size_t>(n));
+       i++) {
+    if (sets.Union(edges[i].from, edges[i].to)) {
+      tree.push_back(edges[i]);
+    }
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// run fct(t) for t = 0..nThreads-1 on as many threads, t = 0 runs on the caller
+template <class Fct>
+void Run_Parallel(int nThreads, Fct fct) {
+  vector<thread> workers;
+  for (int t = 1; t < nThreads; t++) {
+    workers.push_back(thread(fct, t));
+  }
+  fct(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// MST_Result of the tree / forest edges of a graph with nNodes nodes. The
+// tree of root hangs from root, all other trees from their lowest node.
+template <typename W>
+MST_Result<W> Make_MST_Result(int nNodes, vector<Edge_t<W>> tree, int root) {
+  MST_Result<W> result;
+  result.cost = 0;
+  for (auto& edge : tree) {
+    if (edge.from > edge.to) {
+      swap(edge.from, edge.to);
+    }
+    result.cost = Saturating_Add(result.cost, edge.weight);
+  }
+  sort(tree.begin(), tree.end(), [](const Edge_t<W>& a, const Edge_t<W>& b) {
+    return (a.from != b.from) ? (a.from < b.from) : (a.to < b.to);
+  });
+
+  // tree neighbors per node as CSR, then one BFS per tree
+  vector<int32_t> offsets(nNodes + 1, 0);
+  for (const auto& edge : tree) {
+    offsets[edge.from + 1]++;
+    offsets[edge.to + 1]++;
+  }
+  for (int x = 0; x < nNodes; x++) {
+    offsets[x + 1] += offsets[x];
+  }
+  vector<int32_t> targets(offsets[nNodes]);
+  vector<int32_t> slot(offsets.begin(), offsets.end() - 1);
+  for (const auto& edge : tree) {
+    targets[slot[edge.from]++] = edge.to;
+    targets[slot[edge.to]++]   = edge.from;
+  }
+  result.nTreeNodes = 0;
+  for (int x = 0; x < nNodes; x++) {
+    result.nTreeNodes += (offsets[x + 1] > offsets[x]) ? 1 : 0;
+  }
+
+  result.parent.assign(nNodes, -1);
+  vector<bool> reached(nNodes, false);
+  vector<int32_t> queue;
+  for (int i = -1; i < nNodes; i++) {
+    int start = (i < 0) ? root : i;
+    if ((start < 0) || (start >= nNodes) || reached[start]) {
+      continue;
+    }
+    reached[start] = true;
+    queue.assign(1, start);
+    for (size_t k = 0; k < queue.size(); k++) {
+      int x = queue[k];
+      for (int32_t e = offsets[x]; e < offsets[x + 1]; e++) {
+        int y = targets[e];
+        if (!reached[y]) {
+          reached[y]       = true;
+          result.parent[y] = x;
+          queue.push_back(y);
+        }
+      }
+    }
+  }
+  result.edges = std::move(tree);
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// "text", "csv" or "bin", returns false for anything else
+bool Parse_Result_Format(const string& name, ResultFormat& format) {
+  if (name == "text") {
+    format = ResultFormat::TEXT;
+  } else if (name == "csv") {
+    format = ResultFormat::CSV;
+  } else if (name == "bin") {
+    format = ResultFormat::BINARY;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// header of a binary result file, the rest is filled in by the caller
+template <typename V>
+ResultFileHeader Result_File_Header(uint32_t kind, int64_t nNodes) {
+  ResultFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, RESULT_FILE_MAGIC, sizeof(header.magic));
+  header.version    = RESULT_FILE_VERSION;
+  header.byteOrder  = GRAPH_BYTE_ORDER;
+  header.kind       = kind;
+  header.valueBytes = sizeof(V);
+  header.valueKind  = Weight_Kind<V>();
+  header.source     = -1;
+  header.nNodes     = nNodes;
+  return header;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void Write_MST(ResultWriter& out, const MST_Result<W>& result, ResultFormat format) {
+  const char* line = "#######################################################\n";
+  switch (format) {
+  case ResultFormat::TEXT:
+    for (const auto& edge : result.edges) {
+      out.Put("edge: ");
+      out.Put_Int(edge.from, 2);
+      out.Put(" to ");
+      out.Put_Int(edge.to, 2);
+      out.Put(" with cost ");
+      out.Put_Number(edge.weight);
+      out.Put('\n');
+    }
+    out.Put(line);
+    out.Put("Total MST Distance: ");
+    out.Put_Number(result.cost);
+    out.Put('\n');
+    out.Put(line);
+    break;
+  case ResultFormat::CSV:
+    out.Put("from,to,weight,color\n");
+    for (const auto& edge : result.edges) {
+      out.Put_Int(edge.from);
+      out.Put(',');
+      out.Put_Int(edge.to);
+      out.Put(',');
+      out.Put_Number_Exact(edge.weight);
+      out.Put(',');
+      out.Put_Int(static_cast<int>(edge.color));
+      out.Put('\n');
+    }
+    break;
+  case ResultFormat::BINARY: {
+    ResultFileHeader header = Result_File_Header<W>(0, result.parent.size());
+    header.nEdges           = result.edges.size();
+    header.nReached         = result.nTreeNodes;
+    header.cost             = static_cast<double>(result.cost);
+    out.Put_Bytes(&header, sizeof(header));
+    out.Put_Bytes(result.parent.data(), result.parent.size() * sizeof(int32_t));
+    for (const auto& edge : result.edges) {
+      out.Put_Bytes(&edge.from, sizeof(int32_t));
+    }
+    for (const auto& edge : result.edges) {
+      out.Put_Bytes(&edge.to, sizeof(int32_t));
+    }
+    for (const auto& edge : result.edges) {
+      out.Put_Bytes(&edge.weight, sizeof(W));
+    }
+    for (const auto& edge : result.edges) {
+      out.Put_Bytes(&edge.color, sizeof(Color));
+    }
+    break;
+  }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void Write_SSSP(ResultWriter& out, const SSSP_Result<W>& result, ResultFormat format) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+  const char* line = "#######################################################\n";
+  double sum       = 0;
+  for (Dist_t d : result.dist) {
+    if (d != Infinity<Dist_t>()) {
+      sum += d;
+    }
+  }
+
+  switch (format) {
+  case ResultFormat::TEXT:
+    out.Put("Vertex\tDistance from Source\n");
+    for (size_t x = 0; x < result.dist.size(); x++) {
+      out.Put_Int(x);
+      out.Put('\t');
+      if (result.dist[x] == Infinity<Dist_t>()) {
+        out.Put("INF");
+      } else {
+        out.Put_Number(result.dist[x]);
+      }
+      out.Put('\n');
+    }
+    out.Put(line);
+    out.Put("Reachable Nodes: ");
+    out.Put_Int(result.nReached);
+    out.Put("\nAverage Distance: ");
+    out.Put_Double(static_cast<float>(sum) / result.dist.size());
+    out.Put('\n');
+    out.Put(line);
+    break;
+  case ResultFormat::CSV:
+    out.Put("node,distance,parent\n");
+    for (size_t x = 0; x < result.dist.size(); x++) {
+      out.Put_Int(x);
+      out.Put(',');
+      if (result.dist[x] == Infinity<Dist_t>()) {
+        out.Put("inf");
+      } else {
+        out.Put_Number_Exact(result.dist[x]);
+      }
+      out.Put(',');
+      out.Put_Int(result.parent[x]);
+      out.Put('\n');
+    }
+    break;
+  case ResultFormat::BINARY: {
+    ResultFileHeader header = Result_File_Header<Dist_t>(1, result.dist.size());
+    header.source           = result.source;
+    header.nReached         = result.nReached;
+    header.cost             = sum;
+    out.Put_Bytes(&header, sizeof(header));
+    out.Put_Bytes(result.dist.data(), result.dist.size() * sizeof(Dist_t));
+    out.Put_Bytes(result.parent.data(), result.parent.size() * sizeof(int32_t));
+    break;
+  }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// parallel Boruvka, returns a minimum spanning forest (the tree of every
+// component). Each thread owns a range of nodes with about the same number of
+// edges. Every round it drops the edges inside a component from the adjacency
+// of its nodes, finds the cheapest remaining edge of each node and offers it
+// to the node's component (compare and swap). Then the components are merged
+// along their cheapest edges, at least every second one vanishes per round.
+// With the order of MST_Less the tree doesn't depend on timing or nThreads.
+// nThreads <= 0 uses one thread per core.
+template <typename W>
+vector<Edge_t<W>> Boruvka_MST_Tree(const GraphCSR<W>& g, int nThreads) {
+  const int n = g.Size();
+
+  // small graphs aren't worth starting threads
+  const int minEdgesPerThread = 1 << 16;
+  if (nThreads <= 0) {
+    nThreads = thread::hardware_concurrency();
+  }
+  nThreads = max(1, min(nThreads, g.Get_Num_Edges() / minEdgesPerThread));
+  vector<int> nodeBegin(nThreads + 1, n);
+  for (int x = n - 1; x >= 0; x--) {
+    nodeBegin[int64_t(g.Begin(x)) * nThreads / max(g.Get_Num_Edges(), 1)] = x;
+  }
+  for (int t = nThreads - 1; t >= 0; t--) {
+    nodeBegin[t] = min(nodeBegin[t], nodeBegin[t + 1]);
+  }
+
+  ConcurrentDisjointSets sets(n);
+  vector<int32_t> comp(n);          // root per node, fixed during a round
+  vector<int32_t> edgeIds(g.Get_Num_Edges()); // remaining edges, per node from
+  vector<int32_t> edgeEnd(n);       // g.Begin(x) to edgeEnd[x]
+  vector<int32_t> best(n, -1);      // cheapest edge of the node in this round
+  vector<Edge_t<W>> bestEdge(n);    // ... as (weight, lower node, higher node)
+  unique_ptr<atomic<int32_t>[]> cheapest(new atomic<int32_t>[n]); // node per root
+  vector<vector<Edge_t<W>>> parts(nThreads); // tree edges found per thread
+  for (int x = 0; x < n; x++) {
+    cheapest[x].store(-1, memory_order_relaxed);
+  }
+  Run_Parallel(nThreads, [&](int t) {
+    for (int x = nodeBegin[t]; x < nodeBegin[t + 1]; x++) {
+      for (int e = g.Begin(x); e < g.End(x); e++) {
+        edgeIds[e] = e;
+      }
+      edgeEnd[x] = g.End(x);
+    }
+  });
+
+  bool merged = true;
+  while (merged) {
+    // components are fixed until all cheapest edges are known
+    Run_Parallel(nThreads, [&](int t) {
+      for (int x = nodeBegin[t]; x < nodeBegin[t + 1]; x++) {
+        comp[x] = sets.Find(x);
+      }
+    });
+
+    Run_Parallel(nThreads, [&](int t) {
+      for (int x = nodeBegin[t]; x < nodeBegin[t + 1]; x++) {
+        int32_t c    = comp[x];
+        int32_t kept = g.Begin(x);
+        Edge_t<W> bestOfX;
+        best[x] = -1;
+        for (int32_t k = g.Begin(x); k < edgeEnd[x]; k++) {
+          int32_t e = edgeIds[k];
+          int32_t y = g.Target(e);
+          if (comp[y] == c) {
+            continue; // never needed again
+          }
+          edgeIds[kept++] = e;
+          Edge_t<W> edge  = {min(x, y), max(x, y), g.Weight(e), Color::NO_COLOR};
+          if ((best[x] < 0) || MST_Less(edge, bestOfX)) {
+            best[x] = e;
+            bestOfX = edge;
+          }
+        }
+        edgeEnd[x] = kept;
+        if (best[x] < 0) {
+          continue;
+        }
+        // published by the release of the compare and swap below
+        bestEdge[x] = bestOfX;
+        int32_t current = cheapest[c].load(memory_order_acquire);
+        while (((current < 0) || MST_Less(bestOfX, bestEdge[current])) &&
+               !cheapest[c].compare_exchange_weak(current, x, memory_order_acq_rel)) {
+        }
+      }
+    });
+
+    // merge along the cheapest edges, an edge chosen by both its components
+    // is added only once
+    vector<size_t> treeSize(nThreads);
+    for (int t = 0; t < nThreads; t++) {
+      treeSize[t] = parts[t].size();
+    }
+    Run_Parallel(nThreads, [&](int t) {
+      for (int c = nodeBegin[t]; c < nodeBegin[t + 1]; c++) {
+        int32_t x = cheapest[c].load(memory_order_relaxed);
+        if (x < 0) {
+          continue;
+        }
+        cheapest[c].store(-1, memory_order_relaxed);
+        int32_t e = best[x];
+        if (sets.Union(x, g.Target(e))) {
+          Edge_t<W> edge = {x, g.Target(e), g.Weight(e), g.Get_Color(e)};
+          parts[t].push_back(edge);
+        }
+      }
+    });
+    merged = false;
+    for (int t = 0; t < nThreads; t++) {
+      merged = merged || (parts[t].size() > treeSize[t]);
+    }
+  }
+
+  vector<Edge_t<W>> tree;
+  for (const auto& part : parts) {
+    tree.insert(tree.end(), part.begin(), part.end());
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+DynamicMST<W>::DynamicMST(int nNodes)
+    : n(max(nNodes, 0)), nTreeEdges(0), cost(0), adjacency(n), mark(n, 0), stamp(0) {
+  LctNode node = {{-1, -1}, -1, -1, false};
+  lct.assign(n, node);
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+DynamicMST<W>::DynamicMST(const GraphCSR<W>& g) : DynamicMST(g.Size()) {
+  vector<Edge_t<W>> list = Edge_List(g);
+  edges.reserve(list.size());
+  lct.reserve(n + list.size());
+  for (int x = 0; x < n; x++) {
+    adjacency[x].reserve(g.End(x) - g.Begin(x));
+  }
+  for (const auto& edge : list) {
+    New_Edge(edge.from, edge.to, edge.weight, edge.color);
+  }
+  for (const auto& edge : Kruskal_MST_Tree(n, std::move(list))) {
+    int e           = Find_Edge(edge.from, edge.to);
+    edges[e].inTree = true;
+    cost += static_cast<Cost_t>(edge.weight);
+    nTreeEdges++;
+  }
+
+  // instead of linking edge by edge: every node is a splay tree of its own,
+  // its path parent is the parent in the forest, found by a BFS per tree
+  vector<bool> reached(n, false);
+  vector<int32_t> queue;
+  for (int root = 0; root < n; root++) {
+    if (reached[root]) {
+      continue;
+    }
+    reached[root] = true;
+    queue.assign(1, root);
+    for (size_t i = 0; i < queue.size(); i++) {
+      int x = queue[i];
+      for (const Slot& slot : adjacency[x]) {
+        if (edges[slot.edge].inTree && !reached[slot.node]) {
+          reached[slot.node]        = true;
+          lct[n + slot.edge].parent = x;
+          lct[slot.node].parent     = n + slot.edge;
+          queue.push_back(slot.node);
+        }
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool DynamicMST<W>::Insert_Edge(int x, int y, W weight, Color color) {
+  if ((x < 0) || (y < 0) || (x >= n) || (y >= n) || (x == y) ||
+      (Find_Edge(x, y) >= 0)) {
+    return false;
+  }
+  int e = New_Edge(x, y, weight, color);
+  if (Find_Root(x) != Find_Root(y)) {
+    Link_Edge(e); // joins two trees
+  } else {
+    Try_Replace(e);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool DynamicMST<W>::Delete_Edge(int x, int y) {
+  int e = Find_Edge(x, y);
+  if (e < 0) {
+    return false;
+  }
+  bool inTree = edges[e].inTree;
+  int lo      = edges[e].lo;
+  int hi      = edges[e].hi;
+  if (inTree) {
+    Cut_Edge(e);
+  }
+  Free_Edge(e);
+  if (inTree) {
+    int r = Find_Replacement(lo, hi);
+    if (r >= 0) {
+      Link_Edge(r);
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool DynamicMST<W>::Set_Weight(int x, int y, W weight) {
+  int e = Find_Edge(x, y);
+  if (e < 0) {
+    return false;
+  }
+  Edge& edge = edges[e];
+  if (!edge.inTree) {
+    // not linked, so no maxEdge depends on it
+    edge.weight = weight;
+    Try_Replace(e);
+  } else if (!(edge.weight < weight)) {
+    // a tree edge getting cheaper stays, only the maxEdge above it changes,
+    // after Access there is nothing above it in its splay tree
+    Access(n + e);
+    cost        = cost - static_cast<Cost_t>(edge.weight) + static_cast<Cost_t>(weight);
+    edge.weight = weight;
+    Update(n + e);
+  } else {
+    // heavier: the cheapest edge between the two halves, maybe itself again
+    Cut_Edge(e);
+    edge.weight = weight;
+    Link_Edge(Find_Replacement(edge.lo, edge.hi));
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+vector<Edge_t<W>> DynamicMST<W>::Get_Tree() const {
+  vector<Edge_t<W>> tree;
+  tree.reserve(nTreeEdges);
+  for (const auto& edge : edges) {
+    if ((edge.lo >= 0) && edge.inTree) {
+      Edge_t<W> treeEdge = {edge.lo, edge.hi, edge.weight, edge.color};
+      tree.push_back(treeEdge);
+    }
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+vector<Edge_t<W>> DynamicMST<W>::Get_Edges() const {
+  vector<Edge_t<W>> list;
+  list.reserve(Get_Num_Edges());
+  for (const auto& edge : edges) {
+    if (edge.lo >= 0) {
+      Edge_t<W> listEdge = {edge.lo, edge.hi, edge.weight, edge.color};
+      list.push_back(listEdge);
+    }
+  }
+  return list;
+}
+
+// -----------------------------------------------------------------------------
+// store a new non-tree edge, returns its slot
+template <typename W>
+int DynamicMST<W>::New_Edge(int x, int y, W weight, Color color) {
+  int e;
+  if (freeEdges.empty()) {
+    e = static_cast<int>(edges.size());
+    edges.push_back(Edge());
+    LctNode node = {{-1, -1}, -1, e, false};
+    lct.push_back(node);
+  } else {
+    e = freeEdges.back();
+    freeEdges.pop_back();
+  }
+  Edge& edge  = edges[e];
+  edge.lo     = min(x, y);
+  edge.hi     = max(x, y);
+  edge.weight = weight;
+  edge.color  = color;
+  edge.inTree = false;
+  edge.pos[0] = static_cast<int32_t>(adjacency[edge.lo].size());
+  edge.pos[1] = static_cast<int32_t>(adjacency[edge.hi].size());
+  Slot toHi   = {edge.hi, e};
+  Slot toLo   = {edge.lo, e};
+  adjacency[edge.lo].push_back(toHi);
+  adjacency[edge.hi].push_back(toLo);
+  return e;
+}
+
+// -----------------------------------------------------------------------------
+// remove a non-tree edge, the gap in the adjacency is filled with the last edge
+template <typename W>
+void DynamicMST<W>::Free_Edge(int e) {
+  Edge& edge = edges[e];
+  for (int side = 0; side < 2; side++) {
+    int x             = (side == 0) ? edge.lo : edge.hi;
+    vector<Slot>& adj = adjacency[x];
+    Slot last         = adj.back();
+    Edge& moved       = edges[last.edge];
+    adj[edge.pos[side]] = last;
+    moved.pos[(moved.lo == x) ? 0 : 1] = edge.pos[side];
+    adj.pop_back();
+  }
+  edge.lo = -1;
+  freeEdges.push_back(e);
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void DynamicMST<W>::Link_Edge(int e) {
+  Link(edges[e].lo, n + e);
+  Link(n + e, edges[e].hi);
+  edges[e].inTree = true;
+  cost += static_cast<Cost_t>(edges[e].weight);
+  nTreeEdges++;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void DynamicMST<W>::Cut_Edge(int e) {
+  Cut(edges[e].lo, n + e);
+  Cut(n + e, edges[e].hi);
+  edges[e].inTree = false;
+  cost -= static_cast<Cost_t>(edges[e].weight);
+  nTreeEdges--;
+}
+
+// -----------------------------------------------------------------------------
+// the non-tree edge e closes a cycle, it replaces the heaviest edge on the
+// cycle if it is lighter
+template <typename W>
+void DynamicMST<W>::Try_Replace(int e) {
+  int heaviest = Path_Max(edges[e].lo, edges[e].hi);
+  if (Lighter(e, heaviest)) {
+    Cut_Edge(heaviest);
+    Link_Edge(e);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// cheapest non-tree edge between the trees of u and v, which have just been
+// cut apart, -1 if there is none. Both trees are walked one node at a time in
+// turn until one of them is complete, so the work is bound by the smaller one.
+template <typename W>
+int DynamicMST<W>::Find_Replacement(int u, int v) {
+  // nodes of the tree of u are marked with stamp, those of v with stamp + 1
+  if (stamp >= numeric_limits<int32_t>::max() - 2) {
+    fill(mark.begin(), mark.end(), 0);
+    stamp = 0;
+  }
+  stamp += 2;
+  half[0].assign(1, u);
+  half[1].assign(1, v);
+  mark[u]        = stamp;
+  mark[v]        = stamp + 1;
+  size_t next[2] = {0, 0};
+  int complete   = -1;
+  while (complete < 0) {
+    for (int side = 0; (side < 2) && (complete < 0); side++) {
+      if (next[side] == half[side].size()) {
+        complete = side;
+        break;
+      }
+      int x = half[side][next[side]++];
+      for (const Slot& slot : adjacency[x]) {
+        if (edges[slot.edge].inTree && (mark[slot.node] != stamp + side)) {
+          mark[slot.node] = stamp + side;
+          half[side].push_back(slot.node);
+        }
+      }
+    }
+  }
+
+  // every non-tree edge leaving the complete tree ends in the other one
+  int best = -1;
+  for (int x : half[complete]) {
+    for (const Slot& slot : adjacency[x]) {
+      if ((mark[slot.node] != stamp + complete) && !edges[slot.edge].inTree &&
+          ((best < 0) || Lighter(slot.edge, best))) {
+        best = slot.edge;
+      }
+    }
+  }
+  return best;
+}
+
+// -----------------------------------------------------------------------------
+// maxEdge of x from its own edge and the ones of its children
+template <typename W>
+void DynamicMST<W>::Update(int x) {
+  int heaviest = (x >= n) ? x - n : -1;
+  for (int c : lct[x].child) {
+    if ((c >= 0) && Lighter(heaviest, lct[c].maxEdge)) {
+      heaviest = lct[c].maxEdge;
+    }
+  }
+  lct[x].maxEdge = heaviest;
+}
+
+// -----------------------------------------------------------------------------
+// hand a pending flip down to the children
+template <typename W>
+void DynamicMST<W>::Push(int x) {
+  if (lct[x].flip) {
+    swap(lct[x].child[0], lct[x].child[1]);
+    for (int c : lct[x].child) {
+      if (c >= 0) {
+        lct[c].flip = !lct[c].flip;
+      }
+    }
+    lct[x].flip = false;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// move x one level up in its splay tree
+template <typename W>
+void DynamicMST<W>::Rotate(int x) {
+  int p     = lct[x].parent;
+  int g     = lct[p].parent;
+  int dir   = (lct[p].child[1] == x) ? 1 : 0;
+  int inner = lct[x].child[1 - dir];
+  if (!Is_Splay_Root(p)) {
+    lct[g].child[(lct[g].child[1] == p) ? 1 : 0] = x;
+  }
+  lct[x].parent         = g;
+  lct[x].child[1 - dir] = p;
+  lct[p].parent         = x;
+  lct[p].child[dir]     = inner;
+  if (inner >= 0) {
+    lct[inner].parent = p;
+  }
+  Update(p);
+  Update(x);
+}
+
+// -----------------------------------------------------------------------------
+// make x the root of its splay tree
+template <typename W>
+void DynamicMST<W>::Splay(int x) {
+  // pending flips have to be handed down from the top first
+  splayPath.clear();
+  for (int y = x;; y = lct[y].parent) {
+    splayPath.push_back(y);
+    if (Is_Splay_Root(y)) {
+      break;
+    }
+  }
+  for (auto it = splayPath.rbegin(); it != splayPath.rend(); ++it) {
+    Push(*it);
+  }
+
+  while (!Is_Splay_Root(x)) {
+    int p = lct[x].parent;
+    if (!Is_Splay_Root(p)) {
+      int g = lct[p].parent;
+      // zig-zig rotates the parent first, zig-zag x twice
+      bool sameSide = (lct[g].child[0] == p) == (lct[p].child[0] == x);
+      Rotate(sameSide ? p : x);
+    }
+    Rotate(x);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// make the path from the root of the tree to x the preferred path, afterwards
+// x is the root of the splay tree of that path and has no deeper nodes in it
+template <typename W>
+void DynamicMST<W>::Access(int x) {
+  int last = -1;
+  for (int y = x; y >= 0; y = lct[y].parent) {
+    Splay(y);
+    lct[y].child[1] = last;
+    Update(y);
+    last = y;
+  }
+  Splay(x);
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void DynamicMST<W>::Make_Root(int x) {
+  Access(x);
+  lct[x].flip = !lct[x].flip;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+int DynamicMST<W>::Find_Root(int x) {
+  Access(x);
+  int root = x;
+  Push(root);
+  while (lct[root].child[0] >= 0) {
+    root = lct[root].child[0];
+    Push(root);
+  }
+  Splay(root);
+  return root;
+}
+
+// -----------------------------------------------------------------------------
+// x and y are in different trees
+template <typename W>
+void DynamicMST<W>::Link(int x, int y) {
+  Make_Root(x);
+  lct[x].parent = y;
+}
+
+// -----------------------------------------------------------------------------
+// x and y are neighbors in the tree
+template <typename W>
+void DynamicMST<W>::Cut(int x, int y) {
+  Make_Root(x);
+  Access(y);
+  // the path is x - y, so x is the only node left of y
+  lct[y].child[0] = -1;
+  lct[x].parent   = -1;
+  Update(y);
+}
+
+// -----------------------------------------------------------------------------
+// heaviest edge on the tree path between x and y, which are in the same tree
+template <typename W>
+int DynamicMST<W>::Path_Max(int x, int y) {
+  Make_Root(x);
+  Access(y);
+  return lct[y].maxEdge;
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+void LandmarkIndex<W>::Build(const GraphCSR<W>& g, int nLandmarks) {
+  n = g.Size();
+  k = max(0, min(nLandmarks, n));
+  landmarks.clear();
+  dist.assign(static_cast<size_t>(n) * k, Infinity<Dist_t>());
+  if (k == 0) {
+    return;
+  }
+
+  // distance of every node to the closest landmark so far
+  vector<Dist_t> minDist = Dijkstra_SSSP(g, 0).dist;
+  vector<uint8_t> isLandmark(n, 0);
+  for (int l = 0; l < k; l++) {
+    // the node farthest away, unreachable ones first
+    int next = -1;
+    for (int v = 0; v < n; v++) {
+      if (!isLandmark[v] && ((next < 0) || (minDist[v] > minDist[next]))) {
+        next = v;
+      }
+    }
+    landmarks.push_back(next);
+    isLandmark[next]      = 1;
+    SSSP_Result<W> result = Dijkstra_SSSP(g, next);
+    for (int v = 0; v < n; v++) {
+      dist[static_cast<size_t>(v) * k + l] = result.dist[v];
+      minDist[v] = (l == 0) ? result.dist[v] : min(minDist[v], result.dist[v]);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool LandmarkIndex<W>::Write_File(string fileName, const GraphCSR<W>& g) const {
+  LandmarkFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic));
+  header.version    = LANDMARK_FILE_VERSION;
+  header.byteOrder  = GRAPH_BYTE_ORDER;
+  header.distBytes  = sizeof(Dist_t);
+  header.distKind   = Weight_Kind<Dist_t>();
+  header.nNodes     = n;
+  header.nEdges     = g.Get_Num_Edges();
+  header.graphHash  = Graph_Hash(g);
+  header.nLandmarks = k;
+
+  ofstream file(fileName, ios::binary | ios::trunc);
+  if (!file.is_open()) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(landmarks.data()), k * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(dist.data()),
+             dist.size() * sizeof(Dist_t));
+  return file.good();
+}
+
+// -----------------------------------------------------------------------------
+template <typename W>
+bool LandmarkIndex<W>::Read_File(string fileName, const GraphCSR<W>& g) {
+  ifstream file(fileName, ios::binary | ios::ate);
+  if (!file.is_open()) {
+    cout << "Error opening file" << endl;
+    return false;
+  }
+  int64_t fileSize = file.tellg();
+  file.seekg(0);
+
+  // check that the file was written for this graph on this machine
+  LandmarkFileHeader header;
+  if ((fileSize < static_cast<int64_t>(sizeof(header))) ||
+      !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      (memcmp(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic)) != 0)) {
+    cout << "Error: " << fileName << " is not a landmark file" << endl;
+    return false;
+  }
+  if ((header.version != LANDMARK_FILE_VERSION) ||
+      (header.byteOrder != GRAPH_BYTE_ORDER)) {
+    cout << "Error: unsupported version / byte order of " << fileName << endl;
+    return false;
+  }
+  if ((header.distBytes != sizeof(Dist_t)) ||
+      (header.distKind != Weight_Kind<Dist_t>())) {
+    cout << "Error: weight type of " << fileName << " does not match" << endl;
+    return false;
+  }
+  if ((header.nNodes != g.Size()) || (header.nEdges != g.Get_Num_Edges()) ||
+      (header.graphHash != Graph_Hash(g))) {
+    cout << "Error: " << fileName << " was written for another graph" << endl;
+    return false;
+  }
+  // the landmark count is checked first, so that the size can't overflow
+  if ((header.nLandmarks < 0) || (header.nLandmarks > header.nNodes)) {
+    cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+    return false;
+  }
+  int64_t expectedSize = sizeof(header) + header.nLandmarks * sizeof(int32_t) +
+                         header.nNodes * header.nLandmarks * sizeof(Dist_t);
+  if (fileSize != expectedSize) {
+    cout << "Error: " << fileName << " is truncated or corrupt" << endl;
+    return false;
+  }
+
+  n = header.nNodes;
+  k = header.nLandmarks;
+  landmarks.resize(k);
+  dist.resize(static_cast<size_t>(n) * k);
+  file.read(reinterpret_cast<char*>(landmarks.data()), k * sizeof(int32_t));
+  file.read(reinterpret_cast<char*>(dist.data()), dist.size() * sizeof(Dist_t));
+  if (!file) {
+    cout << "Error reading " << fileName << endl;
+    n = 0;
+    k = 0;
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// every edge of the graph once, the lower node first
+template <typename W>
+vector<Edge_t<W>> Edge_List(const GraphCSR<W>& g) {
+  vector<Edge_t<W>> edges;
+  edges.reserve(g.Get_Num_Edges() / 2);
+  for (int x = 0; x < g.Size(); x++) {
+    for (auto nb : g.Neighbors(x)) {
+      if (x < nb.node) {
+        Edge_t<W> edge = {x, nb.node, nb.weight, nb.color};
+        edges.push_back(edge);
+      }
+    }
+  }
+  return edges;
+}
+
+// -----------------------------------------------------------------------------
+// print the tree edges sorted by node (lower node first) and the total cost,
+// the total cost is summed up in WeightTraits<W>::Dist_t and saturates
+template <typename W>
+void Print_MST(vector<Edge_t<W>> tree) {
+  int nNodes = 0;
+  for (const auto& edge : tree) {
+    nNodes = max(nNodes, max(edge.from, edge.to) + 1);
+  }
+  ResultWriter out;
+  out.Open("-");
+  Write_MST(out, Make_MST_Result(nNodes, std::move(tree)), ResultFormat::TEXT);
+}
+
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+// dense graph kernels: O(n^2) Prim and Dijkstra on the rows of the matrices.
+// Every step is an arg-min over the keys of all nodes followed by a min-plus
+// update of the keys with one row. With AVX2 both run on 8 (Dijkstra) or 4
+// (Prim) nodes at once for the integer weight types, double weights use the
+// scalar kernels. Weights have to be non-negative.
+
+#ifdef __AVX2__
+
+// -----------------------------------------------------------------------------
+// 8 weights as 32 bit lanes
+inline __m256i Load_U32x8(const int32_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline __m256i Load_U32x8(const uint16_t* p) {
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i Load_U32x8(const uint8_t* p) {
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+// 4 weights as 64 bit lanes
+inline __m256i Load_U64x4(const int32_t* p) {
+  return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i Load_U64x4(const uint16_t* p) {
+  return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i Load_U64x4(const uint8_t* p) {
+  int32_t bytes;
+  memcpy(&bytes, p, sizeof(bytes));
+  return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+}
+
+// -----------------------------------------------------------------------------
+// all ones in the lanes whose bit is set in the lowest 8 / 4 bits
+inline __m256i Bits_To_Mask32x8(uint32_t bits) {
+  const __m256i select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  __m256i b            = _mm256_and_si256(_mm256_set1_epi32(bits), select);
+  return _mm256_cmpeq_epi32(b, select);
+}
+
+inline __m256i Bits_To_Mask64x4(uint32_t bits) {
+  const __m256i select = _mm256_setr_epi64x(1, 2, 4, 8);
+  __m256i b            = _mm256_and_si256(_mm256_set1_epi64x(bits), select);
+  return _mm256_cmpeq_epi64(b, select);
+}
+
+// -----------------------------------------------------------------------------
+// smallest of 8 lane minima and its index, the lowest index wins a tie
+inline int Reduce_Arg_Min_U32(__m256i best, __m256i bestIdx, uint32_t& minKey) {
+  alignas(32) uint32_t lanes[8];
+  alignas(32) int32_t lanesIdx[8];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanesIdx), bestIdx);
+  int result = lanesIdx[0];
+  minKey     = lanes[0];
+  for (int i = 1; i < 8; i++) {
+    if ((lanes[i] < minKey) || ((lanes[i] == minKey) && (lanesIdx[i] < result))) {
+      minKey = lanes[i];
+      result = lanesIdx[i];
+    }
+  }
+  return result;
+}
+
+// same for 4 lanes with 64 bit keys
+inline int Reduce_Arg_Min_I64(__m256i best, __m256i bestIdx, int64_t& minKey) {
+  alignas(32) int64_t lanes[4];
+  alignas(32) int64_t lanesIdx[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanesIdx), bestIdx);
+  int result = lanesIdx[0];
+  minKey     = lanes[0];
+  for (int i = 1; i < 4; i++) {
+    if ((lanes[i] < minKey) || ((lanes[i] == minKey) && (lanesIdx[i] < result))) {
+      minKey = lanes[i];
+      result = lanesIdx[i];
+    }
+  }
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// index of the first smallest key, n must be a multiple of 8
+inline int Arg_Min_U32(const uint32_t* key, int n, uint32_t& minKey) {
+  __m256i best    = _mm256_set1_epi32(-1);
+  __m256i bestIdx = _mm256_setzero_si256();
+  __m256i idx     = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i step = _mm256_set1_epi32(8);
+  for (int y = 0; y < n; y += 8) {
+    __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(key + y));
+    __m256i m = _mm256_min_epu32(best, v);
+    // only strictly smaller lanes take the new index, so every lane keeps its
+    // first minimum
+    __m256i notLess = _mm256_cmpeq_epi32(m, best);
+    bestIdx         = _mm256_blendv_epi8(idx, bestIdx, notLess);
+    best            = m;
+    idx             = _mm256_add_epi32(idx, step);
+  }
+  return Reduce_Arg_Min_U32(best, bestIdx, minKey);
+}
+
+// -----------------------------------------------------------------------------
+// Prim with the key (weight << 32 | lower node << 16 | higher node) per node,
+// i.e. the order of MST_Less packed into 64 bit, needs n <= 65536
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Dense(const BitMatrix& conMap,
+                                       const AlignedMatrix<W>& weightMap,
+                                       const AlignedMatrix<Color>& colorMap,
+                                       int sourceNode, true_type) {
+  const int n       = weightMap.Size();
+  const int nPad    = (n + 3) & ~3;
+  const int64_t inf = numeric_limits<int64_t>::max();
+
+  // key of the cheapest edge to the tree, floor is inf for tree nodes and the
+  // padding, so that max(key, floor) keeps them out of the arg-min
+  vector<int64_t, AlignedAllocator<int64_t>> key(nPad, inf);
+  vector<int64_t, AlignedAllocator<int64_t>> floor(nPad, 0);
+  for (int y = n; y < nPad; y++) {
+    floor[y] = inf;
+  }
+
+  vector<Edge_t<W>> tree;
+  int thisNode = sourceNode;
+  while (true) {
+    key[thisNode]   = inf;
+    floor[thisNode] = inf;
+
+    // min-plus update with the row of thisNode, fused with the arg-min over
+    // the new keys, so the keys are only read once per step
+    const W* row         = weightMap.Row(thisNode);
+    const uint64_t* bits = conMap.Row(thisNode);
+    const __m128i x4     = _mm_set1_epi32(thisNode);
+    __m128i y4           = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step   = _mm_set1_epi32(4);
+    const __m256i infv   = _mm256_set1_epi64x(inf);
+    __m256i best         = infv;
+    __m256i bestIdx      = _mm256_setzero_si256();
+    for (int y = 0; y < nPad; y += 4) {
+      __m256i conn = Bits_To_Mask64x4((bits[y >> 6] >> (y & 63)) & 0xf);
+      __m128i lohi = _mm_or_si128(_mm_slli_epi32(_mm_min_epi32(x4, y4), 16),
+                                  _mm_max_epi32(x4, y4));
+      __m256i cand = _mm256_or_si256(_mm256_slli_epi64(Load_U64x4(row + y), 32),
+                                     _mm256_cvtepu32_epi64(lohi));
+      cand         = _mm256_blendv_epi8(infv, cand, conn);
+      __m256i k    = _mm256_load_si256(reinterpret_cast<const __m256i*>(&key[y]));
+      __m256i f    = _mm256_load_si256(reinterpret_cast<const __m256i*>(&floor[y]));
+      k            = _mm256_blendv_epi8(k, cand, _mm256_cmpgt_epi64(k, cand));
+      k            = _mm256_blendv_epi8(k, f, _mm256_cmpgt_epi64(f, k));
+      _mm256_store_si256(reinterpret_cast<__m256i*>(&key[y]), k);
+
+      __m256i less = _mm256_cmpgt_epi64(best, k);
+      bestIdx      = _mm256_blendv_epi8(bestIdx, _mm256_cvtepu32_epi64(y4), less);
+      best         = _mm256_blendv_epi8(best, k, less);
+      y4           = _mm_add_epi32(y4, step);
+    }
+
+    int64_t minKey;
+    thisNode = Reduce_Arg_Min_I64(best, bestIdx, minKey);
+    if (minKey == inf) {
+      break; // the rest can't be reached
+    }
+    int lo = (minKey >> 16) & 0xffff;
+    int hi = minKey & 0xffff;
+    Edge_t<W> edge;
+    edge.from   = (lo == thisNode) ? hi : lo;
+    edge.to     = thisNode;
+    edge.weight = static_cast<W>(minKey >> 32);
+    edge.color  = colorMap(edge.from, edge.to);
+    tree.push_back(edge);
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// Dijkstra on 32 bit distances, settled nodes are kept at infinity as above
+template <typename W>
+vector<typename WeightTraits<W>::Dist_t> Dijkstra_Dense(const BitMatrix& conMap,
+                                                        const AlignedMatrix<W>& weightMap,
+                                                        int src, true_type) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+  const int n        = weightMap.Size();
+  const int nPad     = (n + 7) & ~7;
+  const uint32_t inf = Infinity<Dist_t>();
+  // d + w can't wrap around in 32 bit below this distance
+  const uint32_t maxSafe = numeric_limits<uint32_t>::max() - numeric_limits<W>::max();
+
+  vector<uint32_t, AlignedAllocator<uint32_t>> key(nPad, inf);
+  vector<uint32_t, AlignedAllocator<uint32_t>> floor(nPad, 0);
+  for (int y = n; y < nPad; y++) {
+    floor[y] = inf;
+  }
+  vector<Dist_t> dist(n, Infinity<Dist_t>());
+  if ((src < 0) || (src >= n)) {
+    return dist;
+  }
+  key[src] = 0;
+
+  const __m256i infv = _mm256_set1_epi32(inf);
+  uint32_t du        = 0;
+  int u              = src;
+  while (du != inf) {
+    dist[u]  = du;
+    key[u]   = inf;
+    floor[u] = inf;
+
+    const W* row         = weightMap.Row(u);
+    const uint64_t* bits = conMap.Row(u);
+    if (du > maxSafe) {
+      // rare, the distances are close to overflow: scalar and saturating
+      conMap.For_Each_In_Row(u, [&](int v) {
+        key[v] = max(min<uint32_t>(key[v], Saturating_Add(Dist_t(du), row[v])), floor[v]);
+      });
+      u = Arg_Min_U32(key.data(), nPad, du);
+      continue;
+    }
+
+    // min-plus update with the row of u, fused with the arg-min
+    const __m256i d    = _mm256_set1_epi32(du);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i idx        = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best       = _mm256_set1_epi32(-1);
+    __m256i bestIdx    = _mm256_setzero_si256();
+    for (int y = 0; y < nPad; y += 8) {
+      __m256i conn = Bits_To_Mask32x8((bits[y >> 6] >> (y & 63)) & 0xff);
+      __m256i cand = _mm256_min_epu32(_mm256_add_epi32(d, Load_U32x8(row + y)), infv);
+      cand         = _mm256_blendv_epi8(infv, cand, conn);
+      __m256i k    = _mm256_load_si256(reinterpret_cast<const __m256i*>(&key[y]));
+      __m256i f    = _mm256_load_si256(reinterpret_cast<const __m256i*>(&floor[y]));
+      k            = _mm256_max_epu32(_mm256_min_epu32(k, cand), f);
+      _mm256_store_si256(reinterpret_cast<__m256i*>(&key[y]), k);
+
+      __m256i m       = _mm256_min_epu32(best, k);
+      __m256i notLess = _mm256_cmpeq_epi32(m, best);
+      bestIdx         = _mm256_blendv_epi8(idx, bestIdx, notLess);
+      best            = m;
+      idx             = _mm256_add_epi32(idx, step);
+    }
+    u = Reduce_Arg_Min_U32(best, bestIdx, du);
+  }
+  return dist;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// scalar Prim, same algorithm and tie breaking as above
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Dense(const BitMatrix& conMap,
+                                       const AlignedMatrix<W>& weightMap,
+                                       const AlignedMatrix<Color>& colorMap,
+                                       int sourceNode, false_type) {
+  const int n = weightMap.Size();
+  // cheapest edge to the tree per node, lo < 0 if there is none
+  vector<W> keyWeight(n);
+  vector<int> keyLo(n, -1), keyHi(n, -1);
+  vector<bool> addedNodes(n, false);
+
+  vector<Edge_t<W>> tree;
+  int thisNode = sourceNode;
+  while (true) {
+    addedNodes[thisNode] = true;
+    const W* row         = weightMap.Row(thisNode);
+    conMap.For_Each_In_Row(thisNode, [&](int y) {
+      int lo = min(thisNode, y);
+      int hi = max(thisNode, y);
+      if (!addedNodes[y] &&
+          ((keyLo[y] < 0) || (row[y] < keyWeight[y]) ||
+           ((row[y] == keyWeight[y]) && (make_pair(lo, hi) < make_pair(keyLo[y], keyHi[y]))))) {
+        keyWeight[y] = row[y];
+        keyLo[y]     = lo;
+        keyHi[y]     = hi;
+      }
+    });
+
+    thisNode = -1;
+    for (int y = 0; y < n; y++) {
+      if (!addedNodes[y] && (keyLo[y] >= 0) &&
+          ((thisNode < 0) || (keyWeight[y] < keyWeight[thisNode]) ||
+           ((keyWeight[y] == keyWeight[thisNode]) &&
+            (make_pair(keyLo[y], keyHi[y]) < make_pair(keyLo[thisNode], keyHi[thisNode]))))) {
+        thisNode = y;
+      }
+    }
+    if (thisNode < 0) {
+      break; // the rest can't be reached
+    }
+    Edge_t<W> edge;
+    edge.from   = (keyLo[thisNode] == thisNode) ? keyHi[thisNode] : keyLo[thisNode];
+    edge.to     = thisNode;
+    edge.weight = keyWeight[thisNode];
+    edge.color  = colorMap(edge.from, edge.to);
+    tree.push_back(edge);
+  }
+  return tree;
+}
+
+// -----------------------------------------------------------------------------
+// scalar Dijkstra
+template <typename W>
+vector<typename WeightTraits<W>::Dist_t> Dijkstra_Dense(const BitMatrix& conMap,
+                                                        const AlignedMatrix<W>& weightMap,
+                                                        int src, false_type) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+  const int n = weightMap.Size();
+  vector<Dist_t> dist(n, Infinity<Dist_t>());
+  vector<bool> sptSet(n, false);
+  if ((src < 0) || (src >= n)) {
+    return dist;
+  }
+  dist[src] = 0;
+  for (int count = 0; count < n; count++) {
+    int u = -1;
+    for (int v = 0; v < n; v++) {
+      if (!sptSet[v] && ((u < 0) || (dist[v] < dist[u]))) {
+        u = v;
+      }
+    }
+    if ((u < 0) || (dist[u] == Infinity<Dist_t>())) {
+      break;
+    }
+    sptSet[u]    = true;
+    const W* row = weightMap.Row(u);
+    conMap.For_Each_In_Row(u, [&](int v) {
+      if (!sptSet[v]) {
+        dist[v] = min(dist[v], Saturating_Add(dist[u], row[v]));
+      }
+    });
+  }
+  return dist;
+}
+
+// -----------------------------------------------------------------------------
+// pick the SIMD kernel if there is one for W
+template <typename W>
+vector<Edge_t<W>> Prims_MST_Tree_Dense(const BitMatrix& conMap,
+                                       const AlignedMatrix<W>& weightMap,
+                                       const AlignedMatrix<Color>& colorMap,
+                                       int sourceNode) {
+  if ((sourceNode < 0) || (sourceNode >= weightMap.Size())) {
+    return vector<Edge_t<W>>();
+  }
+  if (weightMap.Size() <= 65536) {
+    return Prims_MST_Tree_Dense(conMap, weightMap, colorMap, sourceNode,
+                                typename Dense_Simd<W>::type());
+  }
+  return Prims_MST_Tree_Dense(conMap, weightMap, colorMap, sourceNode, false_type());
+}
+
+template <typename W>
+vector<typename WeightTraits<W>::Dist_t> Dijkstra_Dense(const BitMatrix& conMap,
+                                                        const AlignedMatrix<W>& weightMap,
+                                                        int src) {
+  return Dijkstra_Dense(conMap, weightMap, src, typename Dense_Simd<W>::type());
 }
 
 // -----------------------------------------------------------------------------
-GraphMatrix::GraphMatrix(int32_t nNodes, float prob, vector<int> range) : n(nNodes) {
-  srand(time(NULL)); // seed the random number generator
+// -----------------------------------------------------------------------------
+// all pairs shortest paths: Floyd-Warshall on FW_TILE x FW_TILE tiles of a
+// padded row major distance matrix D. For every block k of intermediate nodes
+//  1. the diagonal tile (k, k) runs plain Floyd-Warshall
+//  2. the other tiles of row and column k are updated with the diagonal tile
+//  3. every other tile gets D(i, j) = min(D(i, j), D(i, k) + D(k, j))
+// The tiles of step 2 and of step 3 are independent of each other, so they
+// are spread over the threads. The three tiles of an update fit into L1, in
+// step 3 a row of D(i, j) stays in registers while k runs. Distances are 32 bit
+// unsigned below FW_INFINITY = 2^31 - 1, the sum of two never wraps around,
+// so min(D, sum) needs no saturation. Weights have to be non-negative.
 
-  // create empty 2d matricies for connections and weights
-  conMap.resize(n);
-  weightMap.resize(n);
-  colorMap.resize(n);
+// "no path" in the Floyd-Warshall matrix, longer paths count as no path too
+const uint32_t FW_INFINITY = numeric_limits<int32_t>::max();
+// tile edge, 3 tiles of 16 KB each
+const int FW_TILE = 64;
 
-  for (int i = 0; i < n; i++) {
-    conMap[i].resize(n, false);
-    weightMap[i].resize(n, EdgeWeight::NO_CON);
-    colorMap[i].resize(n, Color::NO_COLOR);
+// -----------------------------------------------------------------------------
+// c(i, j) = min(c(i, j), a(i, k) + b(k, j)) for a tile, with k in the outer
+// loop, so c may be the same tile as a and / or b (steps 1 and 2)
+inline void Min_Plus_Tile_Inplace(uint32_t* c, const uint32_t* a, const uint32_t* b,
+                                  size_t stride) {
+  for (int k = 0; k < FW_TILE; k++) {
+    const uint32_t* bk = b + k * stride;
+    for (int i = 0; i < FW_TILE; i++) {
+      const uint32_t aik = a[i * stride + k];
+      uint32_t* ci       = c + i * stride;
+      if (aik == FW_INFINITY) {
+        continue;
+      }
+#ifdef __AVX2__
+      const __m256i av = _mm256_set1_epi32(aik);
+      for (int j = 0; j < FW_TILE; j += 8) {
+        __m256i cv = _mm256_load_si256(reinterpret_cast<const __m256i*>(ci + j));
+        __m256i bv = _mm256_load_si256(reinterpret_cast<const __m256i*>(bk + j));
+        cv         = _mm256_min_epu32(cv, _mm256_add_epi32(av, bv));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ci + j), cv);
+      }
+#else
+      for (int j = 0; j < FW_TILE; j++) {
+        ci[j] = min(ci[j], aik + bk[j]);
+      }
+#endif
+    }
   }
+}
 
-  for (int x = 0; x < n; x++) {
-    for (int y = x + 1; y < n; y++) {
-      int rCon = rand() % 101; // rand number between 0 and 100
-      // rand number between EdgeWeight::MIN and EdgeWeight::MAX
-      int rWeight = (rand() % range[1]) + range[0];
-      if (rCon < (prob * 100)) {
-        // create new color in range 1-3 (red, green, blue)
-        Color newColor  = static_cast<Color>((rand() % 3) + 1);
-        conMap[x][y]    = true;
-        weightMap[x][y] = rWeight;
-        colorMap[x][y]  = newColor;
-        // unidirected graph, so we need to fill the other way too
-        conMap[y][x]    = true;
-        weightMap[y][x] = rWeight;
-        colorMap[y][x]  = newColor;
+// -----------------------------------------------------------------------------
+// same for three different tiles (step 3), one row of c at a time
+inline void Min_Plus_Tile(uint32_t* c, const uint32_t* a, const uint32_t* b,
+                          size_t stride) {
+  for (int i = 0; i < FW_TILE; i++) {
+    uint32_t* ci       = c + i * stride;
+    const uint32_t* ai = a + i * stride;
+#ifdef __AVX2__
+    const int nVec = FW_TILE / 8;
+    __m256i cv[nVec];
+    for (int v = 0; v < nVec; v++) {
+      cv[v] = _mm256_load_si256(reinterpret_cast<const __m256i*>(ci + 8 * v));
+    }
+    for (int k = 0; k < FW_TILE; k++) {
+      const __m256i av   = _mm256_set1_epi32(ai[k]);
+      const uint32_t* bk = b + k * stride;
+      for (int v = 0; v < nVec; v++) {
+        __m256i bv = _mm256_load_si256(reinterpret_cast<const __m256i*>(bk + 8 * v));
+        cv[v]      = _mm256_min_epu32(cv[v], _mm256_add_epi32(av, bv));
+      }
+    }
+    for (int v = 0; v < nVec; v++) {
+      _mm256_store_si256(reinterpret_cast<__m256i*>(ci + 8 * v), cv[v]);
+    }
+#else
+    for (int k = 0; k < FW_TILE; k++) {
+      const uint32_t aik = ai[k];
+      const uint32_t* bk = b + k * stride;
+      for (int j = 0; j < FW_TILE; j++) {
+        ci[j] = min(ci[j], aik + bk[j]);
       }
     }
+#endif
   }
 }
 
 // -----------------------------------------------------------------------------
-// read in a graph from a file.
-// initial integer == node size of the graph
-// remainder are integer triples: (i, j, cost)
-void GraphMatrix::Read_Graph_File(string fileName) {
-  ifstream file;
-  file.open(fileName);
-  if (!file.is_open()) {
-    cout << "Error opening file" << endl;
-    return;
+// distances between all nodes of a (directed) dense graph and their average,
+// nThreads <= 0: one per core. Returns false if a weight is negative.
+template <typename W>
+bool Floyd_Warshall_APSP(const BitMatrix& conMap, const AlignedMatrix<W>& weightMap,
+                         APSP_Result<W>& result, int nThreads) {
+  static_assert(numeric_limits<W>::is_integer,
+                "Floyd_Warshall_APSP needs integer weights, see FW_INFINITY");
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+  const int n         = weightMap.Size();
+  const int nTiles    = (n + FW_TILE - 1) / FW_TILE;
+  const size_t stride = static_cast<size_t>(nTiles) * FW_TILE;
+  if (nThreads <= 0) {
+    nThreads = max(1u, thread::hardware_concurrency());
   }
 
-  ifstream dataFile(fileName);
-  istream_iterator<int> start(dataFile), end;
-  vector<int> data(start, end);
+  // D = the edge weights, 0 on the diagonal, the padding is not connected
+  vector<uint32_t, AlignedAllocator<uint32_t>> d(stride * stride, FW_INFINITY);
+  bool negative = false;
+  for (int x = 0; x < n; x++) {
+    const W* row = weightMap.Row(x);
+    uint32_t* dx = &d[x * stride];
+    conMap.For_Each_In_Row(x, [&](int y) {
+      negative = negative || (static_cast<int64_t>(row[y]) < 0);
+      dx[y]    = static_cast<uint32_t>(min<int64_t>(row[y], FW_INFINITY));
+    });
+    dx[x] = 0;
+  }
+  if (negative) {
+    cout << "Error: Floyd-Warshall needs non-negative edge weights" << endl;
+    return false;
+  }
+  auto tile = [&](int ti, int tj) {
+    return &d[(ti * stride + tj) * FW_TILE];
+  };
 
-  auto it = data.begin();
-  n       = *it; // get first data
+  for (int kt = 0; kt < nTiles; kt++) {
+    uint32_t* diag = tile(kt, kt);
+    Min_Plus_Tile_Inplace(diag, diag, diag, stride);
+    // row kt (tasks 0..nTiles-1) and column kt (tasks nTiles..)
+    Run_Parallel(nThreads, [&](int t) {
+      for (int task = t; task < 2 * nTiles; task += nThreads) {
+        int other = task % nTiles;
+        if (other == kt) {
+          continue;
+        }
+        if (task < nTiles) {
+          Min_Plus_Tile_Inplace(tile(kt, other), diag, tile(kt, other), stride);
+        } else {
+          Min_Plus_Tile_Inplace(tile(other, kt), tile(other, kt), diag, stride);
+        }
+      }
+    });
+    // all other tiles, a thread takes whole tile rows, which share D(i, k)
+    Run_Parallel(nThreads, [&](int t) {
+      for (int ti = t; ti < nTiles; ti += nThreads) {
+        if (ti == kt) {
+          continue;
+        }
+        for (int tj = 0; tj < nTiles; tj++) {
+          if (tj != kt) {
+            Min_Plus_Tile(tile(ti, tj), tile(ti, kt), tile(kt, tj), stride);
+          }
+        }
+      }
+    });
+  }
 
-  conMap.resize(n);
-  weightMap.resize(n);
-  colorMap.resize(n);
-  nodes.resize(n);
-  for (int i = 0; i < n; i++) {
-    conMap[i].resize(n, false);
-    weightMap[i].resize(n, EdgeWeight::NO_CON);
-    colorMap[i].resize(n, Color::NO_COLOR);
-    nodes[i].resize(n, {EdgeWeight::NO_CON, -1});
+  // the result matrix and the statistics over the pairs x != y with a path
+  result.dist.Resize(n, Infinity<Dist_t>());
+  vector<int64_t> nPairs(nThreads, 0);
+  vector<double> sum(nThreads, 0);
+  vector<uint32_t> longest(nThreads, 0);
+  Run_Parallel(nThreads, [&](int t) {
+    int64_t threadPairs    = 0;
+    double threadSum       = 0;
+    uint32_t threadLongest = 0;
+    for (int x = t; x < n; x += nThreads) {
+      const uint32_t* dx = &d[x * stride];
+      Dist_t* out        = result.dist.Row(x);
+      for (int y = 0; y < n; y++) {
+        if (dx[y] == FW_INFINITY) {
+          continue;
+        }
+        out[y] = static_cast<Dist_t>(dx[y]);
+        if (x != y) {
+          threadPairs++;
+          threadSum    += dx[y];
+          threadLongest = max(threadLongest, dx[y]);
+        }
+      }
+    }
+    nPairs[t]  = threadPairs;
+    sum[t]     = threadSum;
+    longest[t] = threadLongest;
+  });
+  result.nPairs   = 0;
+  result.sum      = 0;
+  result.diameter = 0;
+  for (int t = 0; t < nThreads; t++) {
+    result.nPairs  += nPairs[t];
+    result.sum     += sum[t];
+    result.diameter = max(result.diameter, static_cast<Dist_t>(longest[t]));
   }
+  result.average = (result.nPairs > 0) ? result.sum / result.nPairs : 0;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// statistics of all pairs shortest paths
+template <typename W>
+void Print_APSP(const APSP_Result<W>& result) {
+  const int64_t n = result.dist.Size();
+  cout << "#######################################################" << endl;
+  cout << "Connected pairs: " << result.nPairs << " of " << n * (n - 1) << endl;
+  cout << "Average Distance (all pairs): " << result.average << endl;
+  cout << "Diameter: " << result.diameter << endl;
+  cout << "#######################################################" << endl;
+}
 
-  for (it = (data.begin() + 1); it != data.end(); it++) {
-    // if the current index is needed:
-    auto idx = std::distance(data.begin(), it);
-    if (idx % 3 == 0) {
-      int thisNode     = *(it - 2);
-      int neighborNode = *(it - 1);
-      int weight       = *it;
-      // cout << node << " " << neighbor << " " << weight << endl;
-      conMap[thisNode][neighborNode]    = true;
-      weightMap[thisNode][neighborNode] = weight;
-      nodes[thisNode][neighborNode]     = {weight, neighborNode};
-      conMap[neighborNode][thisNode]    = true;
-      weightMap[neighborNode][thisNode] = weight;
-      nodes[neighborNode][thisNode]     = {weight, thisNode};
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+// Dikstra's Algorithm
 
-      // create new color in range 1-3 (red, green, blue) as file does not specify
-      Color newColor                   = static_cast<Color>((rand() % 3) + 1);
-      colorMap[thisNode][neighborNode] = newColor;
-      colorMap[neighborNode][thisNode] = newColor;
+// -----------------------------------------------------------------------------
+// A utility function to print the constructed distance array
+template <typename D>
+void printSolution(const vector<D>& dist) {
+  double cumSum = 0;
+  // cout << "Vertex \tDistance from Source" << endl;
+  for (int i = 0; i < dist.size(); i++) {
+    if (dist[i] == Infinity<D>()) {
+      // cout << i << "\t\t" << "INF" << endl;
+    } else {
+      // cout << i << "\t\t" << dist[i] << endl;
+      cumSum += dist[i];
     }
   }
-  file.close();
+  cout << "#######################################################" << endl;
+  cout << "Average Distance: " << static_cast<float>(cumSum) / dist.size() << endl;
+  cout << "#######################################################" << endl;
 }
 
 // -----------------------------------------------------------------------------
-void GraphMatrix::Print() {
-  cout << "Colored Connectivity Map: " << endl;
-  cout << "      ";
-  // print column indices
-  for (int i = 0; i < n; i++) {
-    cout << " " << std::setfill('0') << std::setw(2);
-    cout << i << "";
-  }
-  cout << endl;
-  int x {0};
-  int y {0};
-  for (auto i : nodes) {
-    cout << "N " << std::setfill('0') << std::setw(2) << x << ": "; // print row
-                                                                    // indices
-    y = 0;
-    for (auto j : i) {
-      if (x == y) {
-        cout << " \\ ";
-      } else if (j.first != EdgeWeight::NO_CON) {
-        // see
-        // https://stackoverflow.com/questions/4842424/list-of-ansi-color-escape-sequences
-        // for anso color coding
-        switch (colorMap[x][y]) {
-        case Color::RED:
-          cout << "\033[31m";
-          break;
-        case Color::GREEN:
-          cout << "\033[32m";
-          break;
-        case Color::BLUE:
-          cout << "\033[34m";
-          break;
-        }
-        cout << " " << std::setfill('0') << std::setw(2) << j.first;
-        cout << "\033[0m";
-      } else {
-        cout << "   ";
-      }
-      ++y;
-    }
-    cout << endl;
-    ++x;
+// Function that implements Dijkstra's single source shortest path algorithm
+// for a graph represented using adjacency matrix representation
+// distances are summed up in WeightTraits<W>::Dist_t and saturate
+template <typename W>
+void dijkstra(const GraphMatrix<W>& G, int src) {
+  if (G.Is_Dense(DENSE_DIJKSTRA_MIN_DENSITY)) {
+    printSolution(Dijkstra_Dense(G.Get_Connections(), G.Get_Weights(), src));
+  } else {
+    dijkstra(G.Get_CSR(), src);
   }
 }
 
 // -----------------------------------------------------------------------------
-void GraphMatrix::Print_Color() {
-  cout << "Color Map: " << endl;
-  cout << "  ";
-  // print column indices
-  for (int i = 0; i < n; i++) {
-    cout << " " << i << " ";
+template <typename W>
+void dijkstra(const GraphCSR<W>& g, int src) {
+  // print the constructed distance array
+  printSolution(Dijkstra_SSSP(g, src).dist);
+}
+
+// -----------------------------------------------------------------------------
+// Dijkstra single source shortest paths on the CSR graph. The queue holds a
+// node at most once, a shorter path lowers its key in place (decrease-key).
+// Integer weights 0..DIAL_MAX_WEIGHT use Dial's bucket queue, larger integer
+// weights the radix heap, anything else the indexed heap: O((n + m) log n).
+// Weights must not be negative, then a node taken from the queue never gets
+// a shorter path.
+template <typename W>
+SSSP_Result<W> Dijkstra_SSSP(const GraphCSR<W>& g, int src, SSSPQueue queue) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  SSSP_Result<W> result;
+  result.source   = src;
+  result.nReached = 0;
+  result.dist.assign(g.Size(), Infinity<Dist_t>());
+  result.parent.assign(g.Size(), -1);
+  if ((src < 0) || (src >= g.Size())) {
+    return result;
   }
-  cout << endl;
-  for (int x = 0; x < n; x++) {
-    cout << x << ":"; // print row indices
-    for (int y = 0; y < n; y++) {
-      if (x == y) {
-        cout << " \\ ";
-      } else if (conMap[x][y]) {
-        cout << " " << colorMap[x][y] << " ";
-      } else {
-        cout << "   ";
-      }
-    }
-    cout << endl;
+  result.dist[src] = 0;
+
+  // the monotone queues need integer weights and their maximum
+  W minWeight, maxWeight;
+  Weight_Range(g, minWeight, maxWeight);
+  if (!numeric_limits<W>::is_integer || (minWeight < 0)) {
+    queue = SSSPQueue::HEAP;
   }
+  if (queue == SSSPQueue::AUTO) {
+    queue = (maxWeight <= DIAL_MAX_WEIGHT) ? SSSPQueue::DIAL : SSSPQueue::RADIX;
+  }
+
+  if (queue == SSSPQueue::DIAL) {
+    DialQueue<Dist_t> dial(g.Size(), static_cast<int64_t>(maxWeight));
+    Dijkstra_Search(g, dial, result);
+  } else if (queue == SSSPQueue::RADIX) {
+    RadixHeap<Dist_t> radix(g.Size());
+    Dijkstra_Search(g, radix, result);
+  } else {
+    IndexedHeap<Dist_t> heap(g.Size());
+    Dijkstra_Search(g, heap, result);
+  }
+  return result;
 }
 
 // -----------------------------------------------------------------------------
-// Setter / Getter Methods come here...
-// -----------------------------------------------------------------------------
-int GraphMatrix::Get_Num_Edges() {
-  nEdges = 0;
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) {
-      if (conMap[i][j]) {
-        nEdges++;
+// the search itself for any queue with the interface of IndexedHeap, starts
+// from the node with distance 0 in result
+template <typename W, class Queue>
+void Dijkstra_Search(const GraphCSR<W>& g, Queue& queue, SSSP_Result<W>& result) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  queue.Push(result.source, 0);
+  while (!queue.Empty()) {
+    int u     = queue.Pop();
+    Dist_t du = result.dist[u];
+    result.nReached++;
+    for (auto nb : g.Neighbors(u)) {
+      Dist_t d = Saturating_Add(du, nb.weight);
+      if (d < result.dist[nb.node]) {
+        result.dist[nb.node]   = d;
+        result.parent[nb.node] = u;
+        queue.Push(nb.node, d);
       }
     }
   }
-  return nEdges;
 }
 
 // -----------------------------------------------------------------------------
-float GraphMatrix::Get_Density() {
-  int32_t nPossibleEdges = n * (n - 1); // we don't allow self-loop
-  nEdges                 = Get_Num_Edges();
-  density                = (static_cast<float>(nEdges) / nPossibleEdges);
-  return density;
+// smallest and largest edge weight, both 0 for a graph without edges
+template <typename W>
+void Weight_Range(const GraphCSR<W>& g, W& minWeight, W& maxWeight) {
+  minWeight = 0;
+  maxWeight = 0;
+  if (g.Get_Num_Edges() > 0) {
+    minWeight = g.Weight(0);
+    maxWeight = g.Weight(0);
+  }
+  for (int e = 1; e < g.Get_Num_Edges(); e++) {
+    minWeight = min(minWeight, g.Weight(e));
+    maxWeight = max(maxWeight, g.Weight(e));
+  }
 }
 
 // -----------------------------------------------------------------------------
-vector<int> GraphMatrix::Get_Neighbors(int x) {
-  vector<int> neighbors;
-  for (int i = 0; i < n; i++) {
-    if (conMap[x][i]) {
-      neighbors.push_back(i);
+// shortest path from src to dst, the search stops as soon as dst is taken from
+// the queue. With a landmark index it is an A* search: the key of a node is
+// its distance plus the ALT lower bound of its distance to dst, and nodes the
+// landmarks show to be cut off from dst are never queued. The bound is
+// consistent, so a node is still settled only once.
+template <typename W>
+Path_Result<W> Shortest_Path(const GraphCSR<W>& g, int src, int dst,
+                             const LandmarkIndex<W>* alt) {
+  typedef typename WeightTraits<W>::Dist_t Dist_t;
+
+  Path_Result<W> result;
+  result.cost     = Infinity<Dist_t>();
+  result.nSettled = 0;
+  if ((src < 0) || (src >= g.Size()) || (dst < 0) || (dst >= g.Size())) {
+    return result;
+  }
+  if (alt && (alt->Lower_Bound(src, dst) == Infinity<Dist_t>())) {
+    return result;
+  }
+
+  // the bound of a node is computed once, when the node is reached first
+  vector<Dist_t> dist(g.Size(), Infinity<Dist_t>());
+  vector<int32_t> parent(g.Size(), -1);
+  vector<Dist_t> bound(alt ? g.Size() : 0);
+  vector<uint8_t> hasBound(alt ? g.Size() : 0, 0);
+  auto Bound = [&](int v) {
+    if (!alt) {
+      return Dist_t(0);
+    }
+    if (!hasBound[v]) {
+      bound[v]    = alt->Lower_Bound(v, dst);
+      hasBound[v] = 1;
+    }
+    return bound[v];
+  };
+  IndexedHeap<Dist_t> heap(g.Size());
+  dist[src] = 0;
+  heap.Push(src, Bound(src));
+  while (!heap.Empty()) {
+    int u = heap.Pop();
+    result.nSettled++;
+    if (u == dst) {
+      break;
+    }
+    for (auto nb : g.Neighbors(u)) {
+      Dist_t d = Saturating_Add(dist[u], nb.weight);
+      if (d < dist[nb.node]) {
+        Dist_t h = Bound(nb.node);
+        if (h == Infinity<Dist_t>()) {
+          continue;
+        }
+        dist[nb.node]   = d;
+        parent[nb.node] = u;
+        heap.Push(nb.node, Saturating_Add(d, h));
+      }
     }
   }
-  return neighbors;
+
+  if (dist[dst] == Infinity<Dist_t>()) {
+    return result;
+  }
+  result.cost = dist[dst];
+  for (int v = dst; v >= 0; v = parent[v]) {
+    result.path.push_back(v);
+  }
+  reverse(result.path.begin(), result.path.end());
+  return result;
 }
 
 // -----------------------------------------------------------------------------
-void GraphMatrix::Print_Neighbors(int x) {
-  vector<int> neighbors = Get_Neighbors(x);
-  cout << "Neighbors of " << x << ": " << endl;
-  for (auto i : neighbors) {
-    cout << x << "->" << weightMap[x][i] << "->" << i << endl;
+// FNV-1a hash over the nodes, edges and weights of g (not the colors)
+template <typename W>
+uint64_t Graph_Hash(const GraphCSR<W>& g) {
+  uint64_t hash = 14695981039346656037ull;
+  auto add      = [&hash](const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; i++) {
+      hash = (hash ^ p[i]) * 1099511628211ull;
+    }
+  };
+  for (int x = 0; x < g.Size(); x++) {
+    int32_t end = g.End(x);
+    add(&end, sizeof(end));
   }
+  for (int e = 0; e < g.Get_Num_Edges(); e++) {
+    int32_t target = g.Target(e);
+    W weight       = g.Weight(e);
+    add(&target, sizeof(target));
+    add(&weight, sizeof(weight));
+  }
+  return hash;
 }
 
-// -----------------------------------------------------------------------------
-void GraphMatrix::Prims_MST(int sourceNode) {
+// util to swap two ints
+inline void swap(int& x, int& y) {
+  int temp = x;
+  x        = y;
+  y        = temp;
+  return;
+}
 
-  cout << "Running Prims MST algorithm:" << endl;
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+// Benchmarks
 
-  // The priority_queue stores the pair<weight, node>
-  priority_queue<Node_t, std ::vector<Node_t>, std ::greater<Node_t>> q;
+// -----------------------------------------------------------------------------
+// time f() in ms, sink keeps the compiler from removing the work
+template <class Fct>
+float Time_ms(Fct f, int64_t& sink) {
+  auto startTime           = high_resolution_clock::now();
+  sink                    += f();
+  auto stopTime            = high_resolution_clock::now();
+  duration<float> duration = stopTime - startTime;
+  return duration.count() * 1000;
+}
 
-  // The cost of the source node to itself is 0
-  q.push(std::make_pair(0, sourceNode));
+// -----------------------------------------------------------------------------
+// row scans, column scans, random lookups and a full sweep over a n x n weight
+// matrix, for the old vector<vector<int>> and both AlignedMatrix layouts. The
+// sweep touches (x, y) and its transpose (y, x), once row by row and once
+// block by block (T x T blocks), with the same loops for every layout
+void Benchmark_Weight_Layouts(const vector<int>& sizes) {
+  const int nLookups = 1 << 22;
+  const int T        = AlignedMatrix<int>::TILE;
+  int64_t sink       = 0;
 
-  vector<bool> addedNodes(nodes.size(), false);
+  cout << "########## Weight Matrix Layouts ##########" << endl;
+  cout << "times in ms, " << nLookups << " random lookups" << endl;
+  cout << setfill(' ') << setw(7) << "n" << setw(12) << "layout" << setw(10)
+       << "rows" << setw(10) << "columns" << setw(10) << "random" << setw(10)
+       << "sweep" << setw(10) << "blocked" << endl;
 
-  int mst_cost = 0;
-  int lastNode = 0;
+  for (int n : sizes) {
+    // random coordinates shared by all layouts
+    vector<int> xs(nLookups), ys(nLookups);
+    for (int i = 0; i < nLookups; i++) {
+      xs[i] = rand() % n;
+      ys[i] = rand() % n;
+    }
 
-  while (!q.empty()) {
+    // old layout, one heap allocation per row
+    {
+      vector<vector<int>> m(n, vector<int>(n));
+      for (int x = 0; x < n; x++) {
+        for (int y = 0; y < n; y++) {
+          m[x][y] = (x ^ y) & 0xff;
+        }
+      }
+      float tRows = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int x = 0; x < n; x++) {
+              for (int y = 0; y < n; y++) {
+                sum += m[x][y];
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tCols = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int y = 0; y < n; y++) {
+              for (int x = 0; x < n; x++) {
+                sum += m[x][y];
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tRand = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int i = 0; i < nLookups; i++) {
+              sum += m[xs[i]][ys[i]];
+            }
+            return sum;
+          },
+          sink);
+      float tSweep = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int x = 0; x < n; x++) {
+              for (int y = 0; y < n; y++) {
+                sum += m[x][y] + m[y][x];
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tBlocked = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int bx = 0; bx < n; bx += T) {
+              for (int by = 0; by < n; by += T) {
+                for (int x = bx; x < min(bx + T, n); x++) {
+                  for (int y = by; y < min(by + T, n); y++) {
+                    sum += m[x][y] + m[y][x];
+                  }
+                }
+              }
+            }
+            return sum;
+          },
+          sink);
+      cout << setw(7) << n << setw(12) << "vector2d" << setw(10) << tRows
+           << setw(10) << tCols << setw(10) << tRand << setw(10) << tSweep
+           << setw(10) << tBlocked << endl;
+    }
 
-    // Select the item <cost, node> with minimum cost
-    Node_t item = q.top();
-
-    q.pop(); // remove item from queue
-
-    int cost     = item.first;
-    int thisNode = item.second;
-
-    // If the node is node not yet addedNodes to the minimum spanning tree add it,
-    // and increment the cost.
-    if (!addedNodes[thisNode]) {
-      mst_cost += cost;
-      addedNodes[thisNode] = true;
-      cout << "edge: " << setfill('0') << setw(2) << lastNode;
-      cout << " to " << setfill('0') << setw(2) << thisNode;
-      cout << " with cost " << cost << endl;
-      lastNode = item.second;
-
-      // Iterate through all the nodes adjacent to the node taken out of priority
-      // queue. Push only those nodes (weight,node) that are not yet present in the
-      // minumum spanning tree.
-      for (auto& pair_cost_node : this->nodes[thisNode]) {
-        int adjacentNode = pair_cost_node.second;
-        if ((adjacentNode != -1) && (addedNodes[adjacentNode] == false)) {
-          q.push(pair_cost_node);
+    for (Layout layout : {Layout::ROW_MAJOR, Layout::TILED}) {
+      AlignedMatrix<int> m(n, 0, layout);
+      for (int x = 0; x < n; x++) {
+        for (int y = 0; y < n; y++) {
+          m(x, y) = (x ^ y) & 0xff;
         }
       }
+      // each layout is scanned in its natural order
+      float tRows = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            if (layout == Layout::ROW_MAJOR) {
+              for (int x = 0; x < n; x++) {
+                const int* row = m.Row(x);
+                for (int y = 0; y < n; y++) {
+                  sum += row[y];
+                }
+              }
+            } else {
+              // tile by tile, rows inside a tile are contiguous
+              for (int bx = 0; bx < n; bx += T) {
+                for (int by = 0; by < n; by += T) {
+                  for (int x = bx; x < min(bx + T, n); x++) {
+                    const int* row = &m(x, by);
+                    for (int y = 0; y < min(T, n - by); y++) {
+                      sum += row[y];
+                    }
+                  }
+                }
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tCols = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int y = 0; y < n; y++) {
+              for (int x = 0; x < n; x++) {
+                sum += m(x, y);
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tRand = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int i = 0; i < nLookups; i++) {
+              sum += m(xs[i], ys[i]);
+            }
+            return sum;
+          },
+          sink);
+      float tSweep = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int x = 0; x < n; x++) {
+              for (int y = 0; y < n; y++) {
+                sum += m(x, y) + m(y, x);
+              }
+            }
+            return sum;
+          },
+          sink);
+      float tBlocked = Time_ms(
+          [&]() {
+            int64_t sum = 0;
+            for (int bx = 0; bx < n; bx += T) {
+              for (int by = 0; by < n; by += T) {
+                for (int x = bx; x < min(bx + T, n); x++) {
+                  for (int y = by; y < min(by + T, n); y++) {
+                    sum += m(x, y) + m(y, x);
+                  }
+                }
+              }
+            }
+            return sum;
+          },
+          sink);
+      cout << setw(7) << n << setw(12)
+           << (layout == Layout::ROW_MAJOR ? "row-major" : "tiled") << setw(10)
+           << tRows << setw(10) << tCols << setw(10) << tRand << setw(10) << tSweep
+           << setw(10) << tBlocked << endl;
     }
   }
-  cout << "#######################################################" << endl;
-  cout << "Total MST Distance: " << mst_cost << endl;
-  cout << "#######################################################" << endl;
+  cout << "(checksum " << sink << ")" << endl;
 }
-// -----------------------------------------------------------------------------
-// -----------------------------------------------------------------------------
-// Dikstra's Algorithm
 
-// -----------------------------------------------------------------------------
-// A utility function to find the vertex with minimum distance value, from
-// the set of vertices not yet included in shortest path tree
-int minDistance(vector<int> dist, vector<bool> sptSet) {
+// lazy Prim, eager Prim, filter-Kruskal and Boruvka on the same graph, all of
+// them have to find the same tree
+void Benchmark_MST(const GraphCSR<Weight_t>& g) {
+  typedef WeightTraits<Weight_t>::Dist_t Dist_t;
 
-  // Initialize min value
-  int min = numeric_limits<int>::max();
-  int min_index;
+  // every edge of the graph once for Kruskal
+  vector<Edge_t<Weight_t>> edges = Edge_List(g);
 
-  for (int v = 0; v < dist.size(); v++) {
-    if ((sptSet[v] == false) && (dist[v] <= min)) {
-      min       = dist[v];
-      min_index = v;
+  int64_t sink = 0;
+  vector<Edge_t<Weight_t>> lazy, eager, kruskal;
+  float tLazy = Time_ms(
+      [&]() {
+        lazy = Prims_MST_Tree(g, 0);
+        return lazy.size();
+      },
+      sink);
+  float tEager = Time_ms(
+      [&]() {
+        eager = Prims_MST_Tree_Eager(g, 0);
+        return eager.size();
+      },
+      sink);
+  float tKruskal = Time_ms(
+      [&]() {
+        kruskal = Kruskal_MST_Tree(g.Size(), edges);
+        return kruskal.size();
+      },
+      sink);
+
+  // Boruvka with 1, 2, 4, .. threads up to the number of cores, but at least
+  // up to 4 to check that the tree doesn't depend on the thread count
+  vector<int> threadCounts;
+  vector<float> tBoruvka;
+  vector<vector<Edge_t<Weight_t>>> boruvka;
+  for (int nThreads = 1; ; nThreads *= 2) {
+    vector<Edge_t<Weight_t>> tree;
+    tBoruvka.push_back(Time_ms(
+        [&]() {
+          tree = Boruvka_MST_Tree(g, nThreads);
+          return tree.size();
+        },
+        sink));
+    threadCounts.push_back(nThreads);
+    boruvka.push_back(std::move(tree));
+    if (nThreads >= max(4, static_cast<int>(thread::hardware_concurrency()))) {
+      break;
+    }
+  }
+
+  // compare the trees as sorted (lower node, higher node) lists
+  auto normalize = [](vector<Edge_t<Weight_t>>& tree) {
+    Dist_t cost = 0;
+    for (auto& edge : tree) {
+      if (edge.from > edge.to) {
+        swap(edge.from, edge.to);
+      }
+      cost = Saturating_Add(cost, edge.weight);
+    }
+    sort(tree.begin(), tree.end(), MST_Less<Weight_t>);
+    return cost;
+  };
+  auto same = [](const vector<Edge_t<Weight_t>>& a, const vector<Edge_t<Weight_t>>& b) {
+    bool equal = a.size() == b.size();
+    for (size_t i = 0; equal && (i < a.size()); i++) {
+      equal = (a[i].from == b[i].from) && (a[i].to == b[i].to);
     }
+    return equal;
+  };
+  Dist_t lazyCost    = normalize(lazy);
+  Dist_t eagerCost   = normalize(eager);
+  Dist_t kruskalCost = normalize(kruskal);
+  bool sameTree      = same(lazy, eager) && same(lazy, kruskal);
+
+  cout << "########## MST ##########" << endl;
+  cout << "nodes: " << g.Size() << ", edges: " << edges.size() << endl;
+  cout << setfill(' ') << setw(18) << "algorithm" << setw(12) << "time [ms]"
+       << setw(12) << "cost" << endl;
+  cout << setw(18) << "Prim (lazy)" << setw(12) << tLazy << setw(12) << lazyCost
+       << endl;
+  cout << setw(18) << "Prim (eager)" << setw(12) << tEager << setw(12) << eagerCost
+       << endl;
+  cout << setw(18) << "Kruskal (filter)" << setw(12) << tKruskal << setw(12)
+       << kruskalCost << endl;
+  for (size_t i = 0; i < boruvka.size(); i++) {
+    Dist_t cost = normalize(boruvka[i]);
+    string name = "Boruvka (" + to_string(threadCounts[i]) + " thr)";
+    cout << setw(18) << name << setw(12) << tBoruvka[i] << setw(12) << cost << endl;
+    sameTree = sameTree && same(lazy, boruvka[i]);
   }
-  return min_index;
+  cout << (sameTree ? "same tree" : "Error: the trees differ") << endl;
+  cout << "(checksum " << sink << ")" << endl;
 }
 
 // -----------------------------------------------------------------------------
-// A utility function to print the constructed distance array
-void printSolution(vector<int> dist) {
-  int cumSum = 0;
-  // cout << "Vertex \tDistance from Source" << endl;
-  for (int i = 0; i < dist.size(); i++) {
-    if (dist[i] == numeric_limits<int>::max()) {
-      // cout << i << "\t\t" << "INF" << endl;
-    } else {
-      // cout << i << "\t\t" << dist[i] << endl;
-      cumSum += dist[i];
+// CSR based Prim / Dijkstra against the dense kernels on random n node graphs
+// of increasing density, used to find DENSE_MIN_DENSITY and
+// DENSE_DIJKSTRA_MIN_DENSITY (without AVX2 the scalar dense kernels are timed,
+// which Is_Dense never picks)
+void Benchmark_Dense(int nNodes) {
+  int64_t sink = 0;
+
+  cout << "########## Sparse vs Dense Kernels ##########" << endl;
+  cout << "times in ms, " << nNodes << " nodes" << endl;
+  cout << setfill(' ') << setw(9) << "density" << setw(12) << "Prim CSR" << setw(12)
+       << "Prim dense" << setw(14) << "Dijkstra CSR" << setw(16) << "Dijkstra dense"
+       << setw(8) << "check" << endl;
+
+  for (float density : {0.01f, 0.02f, 0.05f, 0.1f, 0.2f, 0.4f, 0.8f}) {
+    GraphMatrix<Weight_t> G(nNodes, density, {1, 99});
+    const GraphCSR<Weight_t>& g = G.Get_CSR();
+    vector<Edge_t<Weight_t>> sparseTree, denseTree;
+    vector<WeightTraits<Weight_t>::Dist_t> sparseDist, denseDist;
+
+    float tPrim = Time_ms(
+        [&]() {
+          sparseTree = Prims_MST_Tree_Eager(g, 0);
+          return sparseTree.size();
+        },
+        sink);
+    float tPrimDense = Time_ms(
+        [&]() {
+          denseTree = Prims_MST_Tree_Dense(G.Get_Connections(), G.Get_Weights(),
+                                           G.Get_Colors(), 0);
+          return denseTree.size();
+        },
+        sink);
+    float tDijkstra = Time_ms(
+        [&]() {
+          sparseDist = Dijkstra_SSSP(g, 0).dist;
+          return sparseDist.size();
+        },
+        sink);
+    float tDijkstraDense = Time_ms(
+        [&]() {
+          denseDist = Dijkstra_Dense(G.Get_Connections(), G.Get_Weights(), 0);
+          return denseDist.size();
+        },
+        sink);
+
+    // both kernels add the nodes in the same order
+    bool same = (sparseTree.size() == denseTree.size()) && (sparseDist == denseDist);
+    for (size_t i = 0; same && (i < sparseTree.size()); i++) {
+      same = (sparseTree[i].from == denseTree[i].from) &&
+             (sparseTree[i].to == denseTree[i].to);
     }
+    cout << setw(9) << G.Get_Density() << setw(12) << tPrim << setw(12) << tPrimDense
+         << setw(14) << tDijkstra << setw(16) << tDijkstraDense << setw(8)
+         << (same ? "ok" : "Error") << endl;
   }
-  cout << "#######################################################" << endl;
-  cout << "Average Distance: " << static_cast<float>(cumSum) / dist.size() << endl;
-  cout << "#######################################################" << endl;
+  cout << "(checksum " << sink << ")" << endl;
 }
 
 // -----------------------------------------------------------------------------
-// Function that implements Dijkstra's single source shortest path algorithm
-// for a graph represented using adjacency matrix representation
-void dijkstra(GraphMatrix G, int src) {
+// a trickle of random changes (80% new weights, 10% deletes, 10% inserts) on
+// DynamicMST against running Kruskal again after a change
+void Benchmark_Dynamic_MST(const GraphCSR<Weight_t>& g, int nChanges) {
+  typedef DynamicMST<Weight_t>::Cost_t Cost_t;
+  int64_t sink = 0;
+  DynamicMST<Weight_t> dyn(0);
+  float tBuild = Time_ms(
+      [&]() {
+        dyn = DynamicMST<Weight_t>(g);
+        return dyn.Get_Num_Tree_Edges();
+      },
+      sink);
 
-  // Create a priority queue to store vertices that
-  int nNodes = G.Get_Num_Nodes();
-  // dist[i] will hold the shortest distance from src to i
-  vector<int> dist(nNodes, numeric_limits<int>::max());
+  // the changes are made up front, edges are picked out of a list of the
+  // current edges
+  minstd_rand gen(1);
+  vector<pair<int, int>> current;
+  for (const auto& edge : dyn.Get_Edges()) {
+    current.push_back(make_pair(edge.from, edge.to));
+  }
+  float tChanges = Time_ms(
+      [&]() {
+        for (int i = 0; i < nChanges; i++) {
+          int kind        = gen() % 10;
+          Weight_t weight = Weight_Cast<Weight_t>(1 + gen() % 99);
+          if ((kind == 0) || current.empty()) {
+            int x = gen() % g.Size();
+            int y = gen() % g.Size();
+            if (dyn.Insert_Edge(x, y, weight)) {
+              current.push_back(make_pair(x, y));
+            }
+          } else {
+            size_t k = gen() % current.size();
+            if (kind == 1) {
+              dyn.Delete_Edge(current[k].first, current[k].second);
+              current[k] = current.back();
+              current.pop_back();
+            } else {
+              dyn.Set_Weight(current[k].first, current[k].second, weight);
+            }
+          }
+        }
+        return dyn.Get_Num_Tree_Edges();
+      },
+      sink);
 
-  // sptSet[i] will be true if vertex i is included in shortest
-  // path tree or shortest distance from src to i is finalized
-  vector<bool> sptSet(nNodes, false);
+  vector<Edge_t<Weight_t>> tree;
+  vector<Edge_t<Weight_t>> edges = dyn.Get_Edges();
+  float tKruskal                 = Time_ms(
+      [&]() {
+        tree = Kruskal_MST_Tree(g.Size(), edges);
+        return tree.size();
+      },
+      sink);
 
-  // Distance of source vertex from itself is always 0
-  dist[src] = 0;
+  // same forest as Kruskal finds
+  vector<Edge_t<Weight_t>> dynTree = dyn.Get_Tree();
+  sort(tree.begin(), tree.end(), MST_Less<Weight_t>);
+  sort(dynTree.begin(), dynTree.end(), MST_Less<Weight_t>);
+  Cost_t cost = 0;
+  bool same   = tree.size() == dynTree.size();
+  for (size_t i = 0; same && (i < tree.size()); i++) {
+    same  = (tree[i].from == dynTree[i].from) && (tree[i].to == dynTree[i].to);
+    cost += tree[i].weight;
+  }
+  same = same && (cost == dyn.Get_Cost());
+
+  cout << "########## Dynamic MST ##########" << endl;
+  cout << "nodes: " << g.Size() << ", edges: " << edges.size() << endl;
+  cout << "build: " << tBuild << " ms" << endl;
+  cout << nChanges << " changes: " << tChanges << " ms, "
+       << tChanges * 1000 / max(nChanges, 1) << " us per change" << endl;
+  cout << "Kruskal from scratch: " << tKruskal << " ms per change" << endl;
+  cout << "MST cost: " << dyn.Get_Cost() << endl;
+  cout << (same ? "same tree" : "Error: the trees differ") << endl;
+  cout << "(checksum " << sink << ")" << endl;
+}
+
+// -----------------------------------------------------------------------------
+// Dijkstra with each queue and Kruskal with / without buckets on random graphs
+// with small and larger integer weights, the same random sources for all
+// queues, std::priority_queue pushes a node again for a shorter path
+void Benchmark_Queues(int nNodes) {
+  typedef WeightTraits<Weight_t>::Dist_t Dist_t;
+  typedef pair<Dist_t, int> Item_t;
+  const int nSources = 10;
+  int64_t sink       = 0;
+
+  auto lazyDijkstra = [](const GraphCSR<Weight_t>& g, int src) {
+    vector<Dist_t> dist(g.Size(), Infinity<Dist_t>());
+    priority_queue<Item_t, vector<Item_t>, greater<Item_t>> q;
+    dist[src] = 0;
+    q.push(Item_t(0, src));
+    while (!q.empty()) {
+      Item_t item = q.top();
+      q.pop();
+      if (item.first != dist[item.second]) {
+        continue; // a shorter path to the node was found later
+      }
+      for (auto nb : g.Neighbors(item.second)) {
+        Dist_t d = Saturating_Add(item.first, nb.weight);
+        if (d < dist[nb.node]) {
+          dist[nb.node] = d;
+          q.push(Item_t(d, nb.node));
+        }
+      }
+    }
+    return dist;
+  };
 
-  // Find shortest path for all vertices
-  for (int count = 0; count < nNodes - 1; count++) {
-    // Pick the minimum distance vertex from the set of vertices not
-    // yet processed. u is always equal to src in the first iteration.
-    int u = minDistance(dist, sptSet);
+  cout << "########## Dijkstra Queues / Bucket Kruskal ##########" << endl;
+  cout << "times in ms, " << nNodes << " nodes, Dijkstra from " << nSources
+       << " sources" << endl;
+  cout << setfill(' ') << setw(8) << "weights" << setw(12) << "density" << setw(11)
+       << "std::pq" << setw(11) << "heap" << setw(11) << "Dial" << setw(11) << "radix"
+       << setw(10) << "Kruskal" << setw(10) << "bucket" << setw(8) << "check" << endl;
 
-    // Mark the picked vertex as processed
-    sptSet[u] = true;
+  for (int maxWeight : {9, 99, 999, 9999}) {
+    for (float density : {0.01f, 0.05f, 0.2f}) {
+      GraphMatrix<Weight_t> G(nNodes, density, {1, maxWeight});
+      const GraphCSR<Weight_t>& g = G.Get_CSR();
+      vector<int> sources;
+      for (int i = 0; i < nSources; i++) {
+        sources.push_back(rand() % nNodes);
+      }
 
-    vector<int> neighbors = G.Get_Neighbors(u); // idx of neighbors of u
+      vector<vector<Dist_t>> reference(nSources);
+      float tLazy = Time_ms(
+          [&]() {
+            for (int i = 0; i < nSources; i++) {
+              reference[i] = lazyDijkstra(g, sources[i]);
+            }
+            return reference[0].size();
+          },
+          sink);
+      bool same = true;
+      auto timeQueue = [&](SSSPQueue queue) {
+        vector<vector<Dist_t>> dist(nSources);
+        float t = Time_ms(
+            [&]() {
+              int64_t nReached = 0;
+              for (int i = 0; i < nSources; i++) {
+                SSSP_Result<Weight_t> result = Dijkstra_SSSP(g, sources[i], queue);
+                nReached += result.nReached;
+                dist[i].swap(result.dist);
+              }
+              return nReached;
+            },
+            sink);
+        same = same && (dist == reference);
+        return t;
+      };
+      float tHeap  = timeQueue(SSSPQueue::HEAP);
+      float tDial  = timeQueue(SSSPQueue::DIAL);
+      float tRadix = timeQueue(SSSPQueue::RADIX);
 
-    // loop through all neighbors of u
-    for (const auto& v : neighbors) {
-      // Update dist[v] only if is not in sptSet, there is an edge from
-      // u to v, and total weight of path from src to  v through u is
-      // smaller than current value of dist[v]
-      if (!sptSet[v] && (dist[u] != numeric_limits<int>::max()) &&
-          (dist[u] + G.Get_Weight(u, v)) < dist[v]) {
-        dist[v] = dist[u] + G.Get_Weight(u, v);
+      vector<Edge_t<Weight_t>> filterTree, bucketTree;
+      float tKruskal = Time_ms(
+          [&]() {
+            filterTree = Kruskal_MST_Tree(g.Size(), Edge_List(g));
+            return filterTree.size();
+          },
+          sink);
+      float tBucket = Time_ms(
+          [&]() {
+            bucketTree = Bucket_Kruskal_MST_Tree(g, maxWeight);
+            return bucketTree.size();
+          },
+          sink);
+      // the filter Kruskal returns the edges in a different order
+      sort(filterTree.begin(), filterTree.end(), MST_Less<Weight_t>);
+      same = same && (filterTree.size() == bucketTree.size());
+      for (size_t i = 0; same && (i < filterTree.size()); i++) {
+        same = (filterTree[i].from == bucketTree[i].from) &&
+               (filterTree[i].to == bucketTree[i].to);
       }
+
+      cout << setw(8) << maxWeight << setw(12) << G.Get_Density() << setw(11) << tLazy
+           << setw(11) << tHeap << setw(11) << tDial << setw(11) << tRadix << setw(10)
+           << tKruskal << setw(10) << tBucket << setw(8) << (same ? "ok" : "Error")
+           << endl;
     }
   }
+  cout << "(checksum " << sink << ")" << endl;
+}
 
-  // print the constructed distance array
-  printSolution(dist);
+// -----------------------------------------------------------------------------
+// random point to point queries (fixed seed) with plain Dijkstra and with ALT,
+// both must find the same cost and every path must add up to it
+void Benchmark_ALT(const GraphCSR<Weight_t>& g, const LandmarkIndex<Weight_t>& alt,
+                   int nQueries) {
+  typedef WeightTraits<Weight_t>::Dist_t Dist_t;
+  int64_t sink = 0;
+  if (g.Size() == 0) {
+    cout << "Error: the graph is empty" << endl;
+    return;
+  }
+  minstd_rand gen(1);
+  vector<pair<int, int>> queries(nQueries);
+  for (auto& q : queries) {
+    q.first  = gen() % g.Size();
+    q.second = gen() % g.Size();
+  }
+
+  // weight of the edge x - y, Infinity if there is none
+  auto edgeWeight = [&g](int x, int y) {
+    for (auto nb : g.Neighbors(x)) {
+      if (nb.node == y) {
+        return static_cast<Dist_t>(nb.weight);
+      }
+    }
+    return Infinity<Dist_t>();
+  };
+  bool same = true;
+  auto check = [&](const Path_Result<Weight_t>& result, int src, int dst) {
+    if (result.path.empty()) {
+      return result.cost == Infinity<Dist_t>();
+    }
+    Dist_t cost = 0;
+    for (size_t i = 1; i < result.path.size(); i++) {
+      cost = Saturating_Add(cost, edgeWeight(result.path[i - 1], result.path[i]));
+    }
+    return (result.path.front() == src) && (result.path.back() == dst) &&
+           (cost == result.cost);
+  };
+
+  vector<Dist_t> costs(nQueries);
+  int64_t nSettledDijkstra = 0, nSettledALT = 0;
+  int nFound               = 0;
+  float tDijkstra          = Time_ms(
+      [&]() {
+        for (int i = 0; i < nQueries; i++) {
+          Path_Result<Weight_t> result =
+              Shortest_Path(g, queries[i].first, queries[i].second);
+          costs[i]          = result.cost;
+          nSettledDijkstra += result.nSettled;
+          nFound           += !result.path.empty();
+          same = same && check(result, queries[i].first, queries[i].second);
+        }
+        return nSettledDijkstra;
+      },
+      sink);
+  float tALT = Time_ms(
+      [&]() {
+        for (int i = 0; i < nQueries; i++) {
+          Path_Result<Weight_t> result =
+              Shortest_Path(g, queries[i].first, queries[i].second, &alt);
+          nSettledALT += result.nSettled;
+          same         = same && (result.cost == costs[i]) &&
+                 check(result, queries[i].first, queries[i].second);
+        }
+        return nSettledALT;
+      },
+      sink);
+
+  int nq = max(nQueries, 1);
+  cout << "########## ALT point to point queries ##########" << endl;
+  cout << "nodes: " << g.Size() << ", edges: " << g.Get_Num_Edges() / 2
+       << ", landmarks: " << alt.Get_Num_Landmarks() << endl;
+  cout << nQueries << " queries, " << nFound << " connected" << endl;
+  cout << setw(10) << "" << setw(12) << "ms/query" << setw(16) << "settled/query"
+       << endl;
+  cout << setw(10) << "Dijkstra" << setw(12) << tDijkstra / nq << setw(16)
+       << nSettledDijkstra / nq << endl;
+  cout << setw(10) << "ALT" << setw(12) << tALT / nq << setw(16) << nSettledALT / nq
+       << endl;
+  cout << (same ? "same costs, paths ok" : "Error: the paths differ") << endl;
+  cout << "(checksum " << sink << ")" << endl;
 }
 
-// util to swap two ints
-inline void swap(int& x, int& y) {
-  int temp = x;
-  x        = y;
-  y        = temp;
-  return;
+// -----------------------------------------------------------------------------
+// Floyd-Warshall on one and on all threads against Dijkstra from every node on
+// random graphs, and the all pairs average against the one of node 0 only
+void Benchmark_APSP(int nNodes) {
+  typedef WeightTraits<Weight_t>::Dist_t Dist_t;
+  int64_t sink = 0;
+  int nThreads = max(1u, thread::hardware_concurrency());
+
+  cout << "########## All Pairs Shortest Paths ##########" << endl;
+  cout << "times in ms, " << nNodes << " nodes, " << nThreads << " threads" << endl;
+  cout << setfill(' ') << setw(9) << "density" << setw(12) << "FW 1 thr" << setw(12)
+       << "FW all thr" << setw(14) << "n x Dijkstra" << setw(12) << "avg node 0"
+       << setw(12) << "avg all" << setw(8) << "check" << endl;
+
+  for (float density : {0.05f, 0.2f, 0.5f}) {
+    GraphMatrix<Weight_t> G(nNodes, density, {1, 99});
+    APSP_Result<Weight_t> serial, parallel;
+    vector<vector<Dist_t>> rows(nNodes);
+
+    float tSerial = Time_ms(
+        [&]() {
+          Floyd_Warshall_APSP(G.Get_Connections(), G.Get_Weights(), serial, 1);
+          return serial.nPairs;
+        },
+        sink);
+    float tParallel = Time_ms(
+        [&]() {
+          Floyd_Warshall_APSP(G.Get_Connections(), G.Get_Weights(), parallel,
+                              nThreads);
+          return parallel.nPairs;
+        },
+        sink);
+    float tDijkstra = Time_ms(
+        [&]() {
+          for (int x = 0; x < nNodes; x++) {
+            rows[x] = Dijkstra_Dense(G.Get_Connections(), G.Get_Weights(), x);
+          }
+          return rows[0].size();
+        },
+        sink);
+
+    // printSolution's average: distances of node 0, unreachable nodes count 0
+    double sum0 = 0;
+    for (Dist_t d : rows[0]) {
+      sum0 += (d == Infinity<Dist_t>()) ? 0 : d;
+    }
+    bool same = (serial.nPairs == parallel.nPairs) && (serial.sum == parallel.sum);
+    for (int x = 0; same && (x < nNodes); x++) {
+      same = equal(rows[x].begin(), rows[x].end(), serial.dist.Row(x)) &&
+             equal(rows[x].begin(), rows[x].end(), parallel.dist.Row(x));
+    }
+    cout << setw(9) << G.Get_Density() << setw(12) << tSerial << setw(12)
+         << tParallel << setw(14) << tDijkstra << setw(12) << sum0 / max(nNodes, 1) << setw(12)
+         << serial.average << setw(8) << (same ? "ok" : "Error") << endl;
+  }
+  cout << "(checksum " << sink << ")" << endl;
 }